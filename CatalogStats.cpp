@@ -0,0 +1,267 @@
+#include "CatalogStats.h"
+#include "LanguageDictionary.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+// Append raw bytes of a fixed-width value
+template <typename T>
+static void putValue(std::string &out, T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// Read a fixed-width value, failing if the block is too short
+template <typename T>
+static bool getValue(const char *bytes, size_t length, size_t &pos, T &value)
+{
+    if (pos + sizeof(value) > length)
+    {
+        return false;
+    }
+    std::memcpy(&value, bytes + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+CatalogStats::CatalogStats()
+{
+    clear();
+}
+
+void CatalogStats::count(const Movie &movie, int delta)
+{
+    movieCount += delta;
+    ratingSum += delta * static_cast<long double>(movie.getRating());
+
+    std::map<double, int>::iterator value = ratingValues.insert(std::make_pair(movie.getRating(), 0)).first;
+    value->second += delta;
+    if (value->second == 0)
+    {
+        ratingValues.erase(value);
+    }
+    ratingBins[binOf(movie.getRating())] += delta;
+
+    int year = movie.getYear() < FIRST_YEAR ? FIRST_YEAR : (movie.getYear() > LAST_YEAR ? LAST_YEAR : movie.getYear());
+    yearCounts[year - FIRST_YEAR] += delta;
+
+    int languageId = movie.getLanguageId();
+    if (languageId >= static_cast<int>(languageCounts.size()))
+    {
+        languageCounts.resize(languageId + 1, 0);
+    }
+    languageCounts[languageId] += delta;
+}
+
+void CatalogStats::add(const Movie &movie)
+{
+    count(movie, 1);
+}
+
+void CatalogStats::remove(const Movie &movie)
+{
+    count(movie, -1);
+}
+
+void CatalogStats::clear()
+{
+    movieCount = 0;
+    ratingSum = 0;
+    ratingValues.clear();
+    std::memset(ratingBins, 0, sizeof(ratingBins));
+    std::memset(yearCounts, 0, sizeof(yearCounts));
+    languageCounts.clear();
+}
+
+int CatalogStats::getMovieCount() const
+{
+    return movieCount;
+}
+
+double CatalogStats::getMinRating() const
+{
+    return ratingValues.empty() ? 0.0 : ratingValues.begin()->first;
+}
+
+double CatalogStats::getMaxRating() const
+{
+    return ratingValues.empty() ? 0.0 : ratingValues.rbegin()->first;
+}
+
+double CatalogStats::getMeanRating() const
+{
+    return movieCount > 0 ? static_cast<double>(ratingSum / movieCount) : 0.0;
+}
+
+int CatalogStats::getRatingBin(int bin) const
+{
+    return bin >= 0 && bin < RATING_BINS ? ratingBins[bin] : 0;
+}
+
+// Nearest tenth above 1.0 (ratings are clamped to 1.0 - 10.0)
+int CatalogStats::binOf(double rating)
+{
+    int bin = static_cast<int>(std::floor(rating * 10.0 + 0.5)) - 10;
+    return bin < 0 ? 0 : (bin >= RATING_BINS ? RATING_BINS - 1 : bin);
+}
+
+int CatalogStats::getYearCount(int year) const
+{
+    return year >= FIRST_YEAR && year <= LAST_YEAR ? yearCounts[year - FIRST_YEAR] : 0;
+}
+
+int CatalogStats::getMinYear() const
+{
+    for (int year = FIRST_YEAR; year <= LAST_YEAR; year++)
+    {
+        if (yearCounts[year - FIRST_YEAR] > 0)
+        {
+            return year;
+        }
+    }
+    return 0;
+}
+
+int CatalogStats::getMaxYear() const
+{
+    for (int year = LAST_YEAR; year >= FIRST_YEAR; year--)
+    {
+        if (yearCounts[year - FIRST_YEAR] > 0)
+        {
+            return year;
+        }
+    }
+    return 0;
+}
+
+int CatalogStats::getLanguageCount(int languageId) const
+{
+    return languageId >= 0 && languageId < static_cast<int>(languageCounts.size()) ? languageCounts[languageId] : 0;
+}
+
+int CatalogStats::getLanguageLimit() const
+{
+    return static_cast<int>(languageCounts.size());
+}
+
+// Layout: uint32 movies, double rating sum,
+//         uint32 n, n x (double rating, uint32 movies),
+//         uint32 years, years x uint32 movies (from FIRST_YEAR),
+//         uint32 n, n x (uint32 movies, uint32 length, language name)
+// The histogram and the rating sum are rebuilt from the exact ratings; the
+// stored sum only rounds the wide one to a double and is not read back.
+void CatalogStats::serialize(std::string &out) const
+{
+    putValue<uint32_t>(out, static_cast<uint32_t>(movieCount));
+    putValue<double>(out, static_cast<double>(ratingSum));
+
+    putValue<uint32_t>(out, static_cast<uint32_t>(ratingValues.size()));
+    for (std::map<double, int>::const_iterator it = ratingValues.begin(); it != ratingValues.end(); ++it)
+    {
+        putValue<double>(out, it->first);
+        putValue<uint32_t>(out, static_cast<uint32_t>(it->second));
+    }
+
+    putValue<uint32_t>(out, static_cast<uint32_t>(LAST_YEAR - FIRST_YEAR + 1));
+    for (int i = 0; i <= LAST_YEAR - FIRST_YEAR; i++)
+    {
+        putValue<uint32_t>(out, static_cast<uint32_t>(yearCounts[i]));
+    }
+
+    uint32_t languages = 0;
+    for (size_t id = 0; id < languageCounts.size(); id++)
+    {
+        languages += languageCounts[id] > 0 ? 1 : 0;
+    }
+    putValue<uint32_t>(out, languages);
+    for (size_t id = 0; id < languageCounts.size(); id++)
+    {
+        if (languageCounts[id] > 0)
+        {
+            const std::string &name = LanguageDictionary::getName(static_cast<int>(id));
+            putValue<uint32_t>(out, static_cast<uint32_t>(languageCounts[id]));
+            putValue<uint32_t>(out, static_cast<uint32_t>(name.size()));
+            out += name;
+        }
+    }
+}
+
+// Parse into a scratch copy and only keep it if every section adds up to
+// the same movie count
+bool CatalogStats::deserialize(const char *bytes, size_t length)
+{
+    CatalogStats loaded;
+    size_t pos = 0;
+    uint32_t movies, count;
+    double sum;
+    if (!getValue(bytes, length, pos, movies) || movies > 0x7fffffffu || !getValue(bytes, length, pos, sum) ||
+        !getValue(bytes, length, pos, count))
+    {
+        return false;
+    }
+    loaded.movieCount = static_cast<int>(movies);
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        double rating;
+        uint32_t entries;
+        if (!getValue(bytes, length, pos, rating) || !getValue(bytes, length, pos, entries) ||
+            !(rating >= 1.0 && rating <= 10.0) || entries == 0 || entries > movies ||
+            !loaded.ratingValues.insert(std::make_pair(rating, static_cast<int>(entries))).second)
+        {
+            return false;
+        }
+        loaded.ratingBins[binOf(rating)] += static_cast<int>(entries);
+        loaded.ratingSum += entries * static_cast<long double>(rating);
+        total += entries;
+    }
+    if (total != movies || !getValue(bytes, length, pos, count) ||
+        count != static_cast<uint32_t>(LAST_YEAR - FIRST_YEAR + 1))
+    {
+        return false;
+    }
+
+    total = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t entries;
+        if (!getValue(bytes, length, pos, entries) || entries > movies)
+        {
+            return false;
+        }
+        loaded.yearCounts[i] = static_cast<int>(entries);
+        total += entries;
+    }
+    if (total != movies || !getValue(bytes, length, pos, count))
+    {
+        return false;
+    }
+
+    total = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t entries, nameLength;
+        if (!getValue(bytes, length, pos, entries) || !getValue(bytes, length, pos, nameLength) ||
+            entries > movies || nameLength > length - pos)
+        {
+            return false;
+        }
+        int id = LanguageDictionary::intern(TextView(bytes + pos, nameLength));
+        pos += nameLength;
+        if (id >= static_cast<int>(loaded.languageCounts.size()))
+        {
+            loaded.languageCounts.resize(id + 1, 0);
+        }
+        loaded.languageCounts[id] += static_cast<int>(entries);
+        total += entries;
+    }
+    if (total != movies || pos != length)
+    {
+        return false;
+    }
+
+    *this = loaded;
+    return true;
+}
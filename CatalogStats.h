@@ -0,0 +1,69 @@
+#ifndef CATALOGSTATS_H
+#define CATALOGSTATS_H
+
+#include "Movie.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// Catalog-wide aggregates kept up to date on every edit: movies per
+// language, per release year and per rating tenth (a histogram), plus the
+// exact lowest/highest rating and the rating total. Reading any of them
+// is O(1) (min/max year look through the fixed 143-year table), and an
+// edit costs O(log r) for r distinct ratings. The whole set is written to
+// movies.dat (see MovieFile) so loading does not have to recount it.
+class CatalogStats
+{
+public:
+    static const int FIRST_YEAR = 1888;  // Movie clamps years to this range
+    static const int LAST_YEAR = 2030;
+    static const int RATING_BINS = 91;   // Tenths from 1.0 to 10.0
+
+private:
+    int movieCount;
+    long double ratingSum;                   // Wide so adds and removes don't drift; rebuilt on load
+    std::map<double, int> ratingValues;      // Movies per exact rating, for min/max
+    int ratingBins[RATING_BINS];             // Movies per rating rounded to a tenth
+    int yearCounts[LAST_YEAR - FIRST_YEAR + 1];
+    std::vector<int> languageCounts;         // Movies per interned language ID
+
+    // Add (delta 1) or remove (delta -1) one movie's contribution
+    void count(const Movie &movie, int delta);
+
+public:
+    CatalogStats();
+
+    // Keep the aggregates in step with the catalog
+    void add(const Movie &movie);
+    void remove(const Movie &movie);
+    void clear();
+
+    int getMovieCount() const;
+
+    // Rating extremes and mean (0 for an empty catalog)
+    double getMinRating() const;
+    double getMaxRating() const;
+    double getMeanRating() const;
+
+    // Movies whose rating rounds to 1.0 + bin / 10 (0 <= bin < RATING_BINS)
+    int getRatingBin(int bin) const;
+    static int binOf(double rating);
+
+    // Movies released in a year, and the first/last year with any (0 if empty)
+    int getYearCount(int year) const;
+    int getMinYear() const;
+    int getMaxYear() const;
+
+    // Movies in an interned language; IDs run below getLanguageLimit()
+    int getLanguageCount(int languageId) const;
+    int getLanguageLimit() const;
+
+    // Append the aggregates in their file form, or restore them from it.
+    // Languages are stored by name, since IDs differ between runs, and the
+    // rating sum is recomputed from the exact ratings instead of read back
+    // as a double.
+    void serialize(std::string &out) const;
+    bool deserialize(const char *bytes, size_t length);
+};
+
+#endif // CATALOGSTATS_H
@@ -0,0 +1,153 @@
+// Mixed reader / writer stress test for ConcurrentMovieDatabase.
+//
+// Reader threads run lookups, filtered scans, name and typo-tolerant
+// searches, top-k and statistics against the published copy while one
+// writer keeps updating, adding and removing movies (singly and in
+// batches) and interning new languages. The writer preserves a few
+// invariants that every reader checks on each consistent view it gets:
+//   - a seed movie's year always matches its rating (one update changes both)
+//   - batch movies come and go in pairs, so the extra count stays even
+//   - the rating summary, the language counts and the language filter agree
+//     with the movie count
+// Built with -fsanitize=thread where the compiler supports it, so data
+// races are reported as well as broken invariants.
+//
+// Usage: ConcurrencyStress [seconds] [readers]
+//        (defaults: 5 seconds, 4 reader threads)
+
+#include "ConcurrentMovieDatabase.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const int SEED_MOVIES = 20000;
+
+// Year the writer pairs with a rating between 5.0 and 6.0
+int yearFor(double rating) {
+    return 1950 + static_cast<int>(rating * 10 + 0.5);
+}
+
+// Check one consistent view; returns the number of broken invariants
+int checkView(const MovieDatabase& database, long step, vector<const Movie*>& rows, vector<TitleMatch>& matches) {
+    int broken = 0;
+    const Movie* seed = database.findMovieById(1 + static_cast<int>(step * 7919 % SEED_MOVIES));
+    if (!seed || seed->getYear() != yearFor(seed->getRating()) || seed->getLanguage().empty()) {
+        broken++;
+    }
+
+    switch (step % 6) {
+        case 0:
+            if (static_cast<int>(database.getRatingSummary().count) != database.getMovieCount() ||
+                (database.getMovieCount() - SEED_MOVIES) % 2 != 0) {
+                broken++;
+            }
+            break;
+        case 1:
+            database.runQuery(MovieQuery().language("english"), rows);
+            if (static_cast<int>(rows.size()) != database.getLanguageCount("English")) {
+                broken++;
+            }
+            break;
+        case 2:
+            database.runQuery(MovieQuery().ratings(5.2, 5.4).orderBy(MovieQuery::ORDER_RATING).limit(20), rows);
+            for (size_t i = 0; i < rows.size(); i++) {
+                broken += rows[i]->getRating() < 5.2 || rows[i]->getRating() > 5.4;
+            }
+            break;
+        case 3:
+            database.findMoviesByName("seed 12", rows);
+            for (size_t i = 0; i < rows.size(); i++) {
+                broken += rows[i]->getLanguage().empty();
+            }
+            break;
+        case 4:
+            database.findSimilarNames("sed 1234", 10, matches);
+            broken += matches.empty();
+            break;
+        default:
+            database.topK(10, rows);
+            for (size_t i = 1; i < rows.size(); i++) {
+                broken += rows[i - 1]->getRating() < rows[i]->getRating();
+            }
+            break;
+    }
+    return broken;
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = argc > 1 ? atoi(argv[1]) : 5;
+    int readerCount = argc > 2 ? atoi(argv[2]) : 4;
+
+    ConcurrentMovieDatabase database;
+    for (int id = 1; id <= SEED_MOVIES; id++) {
+        double rating = 5.0 + (id % 11) / 10.0;
+        database.emplaceMovie("Seed " + to_string(id), id, yearFor(rating), id % 2 ? "English" : "French", rating);
+    }
+    cout << "Seeded " << SEED_MOVIES << " movies; " << readerCount << " readers, 1 writer, " << seconds << " s"
+         << endl;
+
+    atomic<bool> stop(false);
+    atomic<long> reads(0), writes(0), broken(0);
+    vector<thread> threads;
+    for (int r = 0; r < readerCount; r++) {
+        threads.push_back(thread([&, r] {
+            vector<const Movie*> rows;
+            vector<TitleMatch> matches;
+            long step = r;
+            while (!stop) {
+                database.read([&](const MovieDatabase& view) { broken += checkView(view, step, rows, matches); });
+                step++;
+            }
+            reads += step - r;
+        }));
+    }
+
+    threads.push_back(thread([&] {
+        srand(11);
+        long step = 0;
+        int nextExtra = SEED_MOVIES + 1;
+        while (!stop) {
+            int id = 1 + rand() % SEED_MOVIES;
+            double rating = 5.0 + (rand() % 11) / 10.0;
+            string language = step % 3 ? (step % 2 ? "English" : "French") : "Lang" + to_string(step % 40);
+            database.updateMovie(id, "Seed " + to_string(id), yearFor(rating), language, rating);
+
+            if (step % 10 == 0) {
+                // Add a pair in one batch, then drop it in another
+                vector<MovieEdit> edits(2);
+                for (int i = 0; i < 2; i++) {
+                    edits[i].type = MovieEdit::EDIT_ADD;
+                    edits[i].id = nextExtra + i;
+                    edits[i].name = "Extra " + to_string(nextExtra + i);
+                    edits[i].year = 2020;
+                    edits[i].language = "Korean";
+                    edits[i].rating = 7.0;
+                }
+                BatchResult result;
+                database.applyBatch(edits, result);
+                for (int i = 0; i < 2; i++) {
+                    edits[i].type = MovieEdit::EDIT_REMOVE;
+                }
+                database.applyBatch(edits, result);
+                nextExtra += 2;
+            }
+            step++;
+        }
+        writes += step;
+    }));
+
+    this_thread::sleep_for(chrono::seconds(seconds));
+    stop = true;
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    cout << "Reads: " << reads << ", writes: " << writes << ", broken invariants: " << broken << endl;
+    return broken == 0 ? 0 : 1;
+}
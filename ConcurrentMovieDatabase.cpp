@@ -0,0 +1,114 @@
+#include "ConcurrentMovieDatabase.h"
+#include <thread>
+
+ConcurrentMovieDatabase::ConcurrentMovieDatabase() : published(0), readIndicator(0), primary(0)
+{
+    readers[0].value = 0;
+    readers[1].value = 0;
+}
+
+// Announce the reader on the current indicator, then use the published copy
+void ConcurrentMovieDatabase::read(const std::function<void(const MovieDatabase &)> &reader) const
+{
+    int indicator = readIndicator.load();
+    readers[indicator].value.fetch_add(1);
+    reader(copies[published.load()]);
+    readers[indicator].value.fetch_sub(1);
+}
+
+// Move new readers to the other indicator and drain both in turn, so any
+// reader that could have picked up the old copy is gone afterwards
+void ConcurrentMovieDatabase::waitForReaders()
+{
+    int previous = readIndicator.load();
+    int next = 1 - previous;
+
+    while (readers[next].value.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    readIndicator.store(next);
+    while (readers[previous].value.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+// Edit the hidden copy, publish it, then bring the other copy level
+bool ConcurrentMovieDatabase::write(const std::function<bool(MovieDatabase &)> &edit)
+{
+    std::lock_guard<std::mutex> guard(writeLock);
+
+    int visible = published.load();
+    bool result = edit(copies[1 - visible]);
+    published.store(1 - visible);
+    waitForReaders();
+    edit(copies[visible]);
+    return result;
+}
+
+bool ConcurrentMovieDatabase::addMovie(const Movie &movie)
+{
+    return write([&](MovieDatabase &database) { return database.addMovie(movie); });
+}
+
+// Both copies get the movie; only the second one may take it over
+bool ConcurrentMovieDatabase::addMovie(Movie &&movie)
+{
+    int copiesEdited = 0;
+    return write([&](MovieDatabase &database) {
+        return ++copiesEdited == 2 ? database.addMovie(std::move(movie)) : database.addMovie(movie);
+    });
+}
+
+bool ConcurrentMovieDatabase::emplaceMovie(TextView name, int id, int year, TextView language, double rating)
+{
+    return write([&](MovieDatabase &database) { return database.emplaceMovie(name, id, year, language, rating); });
+}
+
+bool ConcurrentMovieDatabase::removeMovie(int id)
+{
+    return write([&](MovieDatabase &database) { return database.removeMovie(id); });
+}
+
+bool ConcurrentMovieDatabase::updateMovie(int id, const std::string &name, int year, const std::string &language,
+                                          double rating)
+{
+    return write([&](MovieDatabase &database) { return database.updateMovie(id, name, year, language, rating); });
+}
+
+bool ConcurrentMovieDatabase::applyBatch(const std::vector<MovieEdit> &edits, BatchResult &result)
+{
+    return write([&](MovieDatabase &database) { return database.applyBatch(edits, result); });
+}
+
+bool ConcurrentMovieDatabase::loadFromFile(const std::string &filename)
+{
+    return write([&](MovieDatabase &database) { return database.loadFromFile(filename); });
+}
+
+// The journal only needs one copy's edits; both see the same sequence
+bool ConcurrentMovieDatabase::openJournal(const std::string &filename)
+{
+    std::lock_guard<std::mutex> guard(writeLock);
+    return copies[primary].openJournal(filename);
+}
+
+void ConcurrentMovieDatabase::closeJournal()
+{
+    std::lock_guard<std::mutex> guard(writeLock);
+    copies[primary].closeJournal();
+}
+
+// Readers may be scanning the primary copy meanwhile; saving only reads it
+bool ConcurrentMovieDatabase::persistChanges()
+{
+    std::lock_guard<std::mutex> guard(writeLock);
+    return copies[primary].persistChanges();
+}
+
+bool ConcurrentMovieDatabase::checkpoint()
+{
+    std::lock_guard<std::mutex> guard(writeLock);
+    return copies[primary].checkpoint();
+}
@@ -0,0 +1,80 @@
+#ifndef CONCURRENTMOVIEDATABASE_H
+#define CONCURRENTMOVIEDATABASE_H
+
+#include "MovieDatabase.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+// Thread-safe front end for MovieDatabase where readers never wait for
+// writers (the "left-right" technique). Two identical databases are kept:
+// readers run against whichever one is currently published, while the
+// single active writer edits the other one, publishes it, waits until no
+// reader is still inside the old copy, and replays the same edit there.
+//
+// Entering and leaving a read only touches two atomic counters, and a
+// writer never holds anything a reader waits for, so edits do not stall
+// lookups. Readers can still wait on each other inside the published copy:
+// - runQuery and findMoviesByName take the copy's QueryCache mutex to look
+//   the query up and again to store its result, but never while the
+//   query itself runs;
+// - multi-chunk scans hold the copy's ScanExecutor run lock, so two scans
+//   on the same copy run one after the other, each on every scan thread;
+// - a language filter looks its name up in LanguageDictionary under a
+//   mutex, once per query. Rendering and sorting by language read the
+//   dictionary without locking.
+// Index lookups such as findMovieById, topK and the trigram search take
+// no lock at all. The price is twice the memory and each edit being
+// applied twice. Edits must be deterministic, which holds for every
+// MovieDatabase mutator. Only the primary copy writes the journal.
+class ConcurrentMovieDatabase
+{
+private:
+    MovieDatabase copies[2];
+    std::atomic<int> published;     // Copy new readers use
+    std::atomic<int> readIndicator; // Which of the two reader counters new readers bump
+    struct ReaderCount // Padded to a cache line: readers hit these constantly
+    {
+        std::atomic<int> value;
+        char padding[64 - sizeof(std::atomic<int>)];
+    };
+    mutable ReaderCount readers[2]; // Readers inside, per indicator
+    std::mutex writeLock; // Serializes writers
+    int primary;          // Copy that owns the journal
+
+    // Wait until every reader that might still see the old copy has left
+    void waitForReaders();
+
+public:
+    ConcurrentMovieDatabase();
+
+    ConcurrentMovieDatabase(const ConcurrentMovieDatabase &) = delete;
+    ConcurrentMovieDatabase &operator=(const ConcurrentMovieDatabase &) = delete;
+
+    // Run a read-only function against a consistent copy. Pointers into
+    // the database are valid only until the function returns.
+    void read(const std::function<void(const MovieDatabase &)> &reader) const;
+
+    // Apply an edit to both copies; readers see it all at once. The edit
+    // runs twice and must produce the same result both times.
+    bool write(const std::function<bool(MovieDatabase &)> &edit);
+
+    // Convenience wrappers for the common edits
+    bool addMovie(const Movie &movie);
+    bool addMovie(Movie &&movie);
+    bool emplaceMovie(TextView name, int id, int year, TextView language, double rating);
+    bool removeMovie(int id);
+    bool updateMovie(int id, const std::string &name, int year, const std::string &language, double rating);
+    bool applyBatch(const std::vector<MovieEdit> &edits, BatchResult &result);
+
+    // Load both copies from a data file (and its journal)
+    bool loadFromFile(const std::string &filename = "movies.dat");
+
+    // Journal and checkpoint through the primary copy
+    bool openJournal(const std::string &filename = "movies.dat");
+    void closeJournal();
+    bool persistChanges();
+    bool checkpoint();
+};
+
+#endif // CONCURRENTMOVIEDATABASE_H
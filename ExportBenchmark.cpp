@@ -0,0 +1,87 @@
+// Benchmark for CSV / JSON Lines export.
+//
+// Exports a synthetic catalog with exportToFile in both formats and, for
+// comparison, with a naive exporter that streams every field with
+// operator<< (building the name and language strings per row).
+//
+// Usage: ExportBenchmark [movies] [directory]
+//        (default: 1000000 movies, written to the current directory)
+
+#include "MovieDatabase.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// The obvious per-field exporter (CSV, no quoting)
+bool naiveExport(const MovieDatabase& database, int count, const string& filename) {
+    ofstream file(filename.c_str());
+    file << "id,name,year,language,rating\n";
+    for (int id = 1; id <= count; id++) {
+        const Movie* movie = database.findMovieById(id);
+        file << movie->getId() << ',' << movie->getName() << ',' << movie->getYear() << ','
+             << movie->getLanguage() << ',' << movie->getRating() << '\n';
+    }
+    return file.good();
+}
+
+// Size of a file in bytes
+long long fileBytes(const string& filename) {
+    ifstream file(filename.c_str(), ios::binary | ios::ate);
+    return file ? static_cast<long long>(file.tellg()) : 0;
+}
+
+// Milliseconds taken by fn
+template <typename Fn>
+double timeMs(Fn fn) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    fn();
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void report(const string& label, const string& filename, double ms, int count) {
+    double mb = fileBytes(filename) / (1024.0 * 1024.0);
+    cout << "  " << left << setw(22) << label << right << setw(8) << ms << " ms  "
+         << setw(7) << mb / (ms / 1000.0) << " MB/s  "
+         << setw(6) << count / (ms / 1000.0) / 1e6 << " M rows/s" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    string directory = argc > 2 ? string(argv[2]) + "/" : "";
+
+    const char* languages[] = {"English", "French", "Korean", "Japanese", "Italian", "Spanish", "Portuguese"};
+    MovieDatabase database;
+    database.reserve(count);
+    srand(42);
+    for (int i = 1; i <= count; i++) {
+        string name = "Movie number " + to_string(i);
+        if (i % 10 == 0) name += ", Part \"" + to_string(i % 7) + "\""; // Needs CSV quoting / JSON escapes
+        database.addMovie(Movie(name, i, 1900 + rand() % 125, languages[rand() % 7], (rand() % 91 + 10) / 10.0));
+    }
+
+    string csvFile = directory + "export_bench.csv";
+    string jsonFile = directory + "export_bench.jsonl";
+    string naiveFile = directory + "export_bench_naive.csv";
+
+    double csv = timeMs([&] { database.exportToFile(csvFile, MovieExporter::FORMAT_CSV); });
+    double json = timeMs([&] { database.exportToFile(jsonFile, MovieExporter::FORMAT_JSON_LINES); });
+    double naive = timeMs([&] { naiveExport(database, count, naiveFile); });
+
+    cout << "Rows: " << count << endl;
+    cout << fixed << setprecision(1);
+    report("CSV (exporter)", csvFile, csv, count);
+    report("JSON Lines (exporter)", jsonFile, json, count);
+    report("CSV (per-field <<)", naiveFile, naive, count);
+
+    remove(csvFile.c_str());
+    remove(jsonFile.c_str());
+    remove(naiveFile.c_str());
+    return 0;
+}
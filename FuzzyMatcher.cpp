@@ -0,0 +1,93 @@
+#include "FuzzyMatcher.h"
+#include <algorithm>
+#include <cstring>
+
+FuzzyMatcher::FuzzyMatcher(const std::string &foldedTerm)
+    : term(foldedTerm), lastBit(0)
+{
+    std::memset(masks, 0, sizeof(masks));
+    if (!term.empty() && term.size() <= MAX_BIT_PARALLEL)
+    {
+        for (size_t i = 0; i < term.size(); i++)
+        {
+            masks[static_cast<unsigned char>(term[i])] |= static_cast<uint64_t>(1) << i;
+        }
+        lastBit = static_cast<uint64_t>(1) << (term.size() - 1);
+    }
+}
+
+// Myers' algorithm in its search form (Hyyro's formulation): the columns of
+// the edit-distance table are kept as bit vectors of +1/-1 vertical
+// differences, and the top row stays 0 so a match may start anywhere
+int FuzzyMatcher::bitParallelDistance(TextView text) const
+{
+    uint64_t plus = ~static_cast<uint64_t>(0), minus = 0;
+    int score = static_cast<int>(term.size());
+    int best = score;
+    for (size_t j = 0; j < text.size() && best > 0; j++)
+    {
+        uint64_t equal = masks[static_cast<unsigned char>(text[j])];
+        uint64_t vertical = equal | minus;
+        uint64_t horizontal = (((equal & plus) + plus) ^ plus) | equal;
+        uint64_t horizontalPlus = minus | ~(horizontal | plus);
+        uint64_t horizontalMinus = plus & horizontal;
+        if (horizontalPlus & lastBit)
+        {
+            score++;
+        }
+        else if (horizontalMinus & lastBit)
+        {
+            score--;
+        }
+        horizontalPlus <<= 1;
+        horizontalMinus <<= 1;
+        plus = horizontalMinus | ~(vertical | horizontalPlus);
+        minus = horizontalPlus & vertical;
+        best = std::min(best, score);
+    }
+    return best;
+}
+
+// Plain dynamic program, one column of the table per title byte
+int FuzzyMatcher::tableDistance(TextView text, int limit) const
+{
+    size_t m = term.size();
+    column.resize(m + 1);
+    for (size_t i = 0; i <= m; i++)
+    {
+        column[i] = static_cast<int>(i);
+    }
+    int best = static_cast<int>(m);
+    for (size_t j = 0; j < text.size() && best > 0; j++)
+    {
+        int diagonal = 0; // Top row is 0: a match may start at any byte
+        for (size_t i = 1; i <= m; i++)
+        {
+            int left = column[i];
+            int cost = term[i - 1] == text[j] ? 0 : 1;
+            column[i] = std::min(std::min(column[i - 1] + 1, left + 1), diagonal + cost);
+            diagonal = left;
+        }
+        best = std::min(best, column[m]);
+    }
+    return std::min(best, limit + 1);
+}
+
+int FuzzyMatcher::distanceIn(TextView text, int limit) const
+{
+    if (term.empty())
+    {
+        return 0;
+    }
+    if (term.size() > MAX_BIT_PARALLEL)
+    {
+        return tableDistance(text, limit);
+    }
+    return std::min(bitParallelDistance(text), limit + 1);
+}
+
+int FuzzyMatcher::defaultLimit(size_t termLength)
+{
+    int limit = static_cast<int>(termLength / 4);
+    return limit < 1 ? 1 : (limit > 3 ? 3 : limit);
+}
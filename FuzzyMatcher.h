@@ -0,0 +1,42 @@
+#ifndef FUZZYMATCHER_H
+#define FUZZYMATCHER_H
+
+#include "StringPool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Typo-tolerant matching of one search term against many titles. The
+// distance reported is the number of single-byte edits (insert, delete,
+// substitute) that turn the term into the closest part of the title, so
+// "shawshenk" is 1 away from "the shawshank redemption". Both sides are
+// expected to be case-folded already.
+//
+// Terms of up to 64 bytes use Myers' bit-parallel algorithm: one pass over
+// the title with a handful of word operations per byte. Longer terms fall
+// back to the textbook dynamic program.
+class FuzzyMatcher
+{
+private:
+    std::string term;
+    uint64_t masks[256]; // Bit i set where term[i] is that byte
+    uint64_t lastBit;    // Bit of the term's final byte
+    mutable std::vector<int> column; // One column of the edit table, for long terms
+
+    int bitParallelDistance(TextView text) const;
+    int tableDistance(TextView text, int limit) const;
+
+public:
+    static const size_t MAX_BIT_PARALLEL = 64;
+
+    explicit FuzzyMatcher(const std::string &foldedTerm);
+
+    // Edits between the term and its closest substring of 'text'. Anything
+    // above 'limit' is reported as limit + 1.
+    int distanceIn(TextView text, int limit) const;
+
+    // Default edit budget for a term: one edit per four bytes, 1 to 3
+    static int defaultLimit(size_t termLength);
+};
+
+#endif // FUZZYMATCHER_H
@@ -0,0 +1,100 @@
+// Benchmark for lookups by movie ID.
+//
+// Builds synthetic catalogs of increasing size and times random
+// findMovieById and updateMovie calls, which go through the ID -> slot
+// hash index, against a linear search of the same catalog by ID (what
+// every lookup used to cost). Index latency should stay flat as the
+// catalog grows while the linear search grows with it.
+//
+// Usage: IdLookupBenchmark [lookups] [sizes...]
+//        (defaults: 1000000 lookups; 10000, 100000 and 1000000 movies)
+
+#include "MovieDatabase.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Nanoseconds per call of fn, averaged over 'repeats' calls
+template <typename Fn>
+double timeNs(int repeats, Fn fn) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        fn(i);
+    }
+    chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / repeats;
+}
+
+string formatNs(double ns) {
+    ostringstream cell;
+    cell << fixed << setprecision(ns < 100 ? 1 : 0) << ns << " ns";
+    return cell.str();
+}
+
+int main(int argc, char* argv[]) {
+    int lookups = argc > 1 ? atoi(argv[1]) : 1000000;
+    vector<int> sizes;
+    for (int i = 2; i < argc; i++) {
+        sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(10000);
+        sizes.push_back(100000);
+        sizes.push_back(1000000);
+    }
+
+    cout << left << setw(12) << "Movies" << setw(18) << "findMovieById" << setw(18) << "updateMovie" << setw(18)
+         << "linear search" << endl;
+    for (size_t s = 0; s < sizes.size(); s++) {
+        int count = sizes[s];
+        MovieDatabase database;
+        database.setStorageMode(MovieDatabase::STORAGE_POOLED);
+        database.reserve(count);
+        for (int id = 1; id <= count; id++) {
+            database.emplaceMovie("Movie " + to_string(id), id, 1900 + id % 125, "English", (id % 91 + 10) / 10.0);
+        }
+
+        // Random IDs, drawn up front so the draw isn't timed
+        srand(1);
+        vector<int> ids(lookups);
+        for (int i = 0; i < lookups; i++) {
+            double r = (rand() * (RAND_MAX + 1.0) + rand()) / ((RAND_MAX + 1.0) * (RAND_MAX + 1.0));
+            ids[i] = 1 + static_cast<int>(r * count);
+        }
+
+        long long checksum = 0;
+        double lookup = timeNs(lookups, [&](int i) {
+            const Movie* movie = database.findMovieById(ids[i]);
+            checksum += movie ? movie->getYear() : 0;
+        });
+
+        int updates = min(lookups, 100000);
+        double update = timeNs(updates, [&](int i) {
+            const Movie* movie = database.findMovieById(ids[i]);
+            database.updateMovie(ids[i], movie->getName(), movie->getYear(), "English", movie->getRating());
+        });
+
+        // Linear search by ID over the same movies; few repeats, it is slow
+        vector<const Movie*> all;
+        database.runQuery(MovieQuery(), all);
+        int scans = max(10, 2000000 / count);
+        double linear = timeNs(scans, [&](int i) {
+            for (size_t slot = 0; slot < all.size(); slot++) {
+                if (all[slot]->getId() == ids[i]) {
+                    checksum += all[slot]->getYear();
+                    break;
+                }
+            }
+        });
+
+        cout << setw(12) << count << setw(18) << formatNs(lookup) << setw(18) << formatNs(update) << setw(18)
+             << formatNs(linear) << "(checksum " << checksum << ")" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Throughput benchmark for the aggregate scan kernels.
+//
+// Fills rating and year columns like MovieColumns holds them and runs
+// each ScanKernels operation (summaries, range counts, range filters)
+// with the implementation picked at startup and with the portable scalar
+// one, reporting GB/s of column data read. Both implementations must
+// return identical results.
+//
+// Usage: KernelBenchmark [values] [repeats]
+//        (defaults: 1000000 values, 200 repeats)
+
+#include "ScanKernels.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Seconds per call of fn, averaged over 'repeats' calls
+template <typename Fn>
+double timeSeconds(int repeats, Fn fn) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        fn();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / repeats;
+}
+
+string formatRate(size_t bytes, double seconds) {
+    ostringstream cell;
+    cell << fixed << setprecision(2) << bytes / seconds / 1e9 << " GB/s";
+    return cell.str();
+}
+
+// Results of every kernel, to compare implementations
+struct Results {
+    RatingSummary ratings;
+    YearSummary years;
+    size_t ratingCount;
+    size_t yearCount;
+    size_t ratingRows;
+    size_t yearRows;
+};
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 1000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 200;
+
+    vector<double> ratings(count);
+    vector<int> years(count);
+    srand(9);
+    for (size_t i = 0; i < count; i++) {
+        ratings[i] = (rand() % 91 + 10) / 10.0;
+        years[i] = 1900 + rand() % 125;
+    }
+
+    const char* selected = ScanKernels::getName();
+    cout << "Columns: " << count << " ratings (double) and years (int), " << repeats << " repeats" << endl << endl;
+    cout << left << setw(30) << "Kernel" << setw(16) << selected << setw(16) << "scalar" << "speedup" << endl;
+
+    const char* labels[] = {"summarize ratings", "summarize years", "count ratings 7.0-8.5",
+                            "count years 2000-2009", "filter ratings 9.0-10.0", "filter years 2020-2024"};
+    size_t bytes[] = {count * sizeof(double), count * sizeof(int), count * sizeof(double),
+                      count * sizeof(int), count * sizeof(double), count * sizeof(int)};
+    double seconds[2][6];
+    Results results[2];
+    vector<int> slots;
+    slots.reserve(count);
+    for (int pass = 0; pass < 2; pass++) {
+        ScanKernels::useScalar(pass == 1);
+        Results& r = results[pass];
+        seconds[pass][0] = timeSeconds(repeats, [&] { r.ratings = ScanKernels::summarize(ratings.data(), count); });
+        seconds[pass][1] = timeSeconds(repeats, [&] { r.years = ScanKernels::summarize(years.data(), count); });
+        seconds[pass][2] = timeSeconds(repeats, [&] {
+            r.ratingCount = ScanKernels::countInRange(ratings.data(), count, 7.0, 8.5);
+        });
+        seconds[pass][3] = timeSeconds(repeats, [&] {
+            r.yearCount = ScanKernels::countInRange(years.data(), count, 2000, 2009);
+        });
+        seconds[pass][4] = timeSeconds(repeats, [&] {
+            slots.clear();
+            ScanKernels::filterInRange(ratings.data(), count, 9.0, 10.0, slots);
+        });
+        r.ratingRows = slots.size();
+        seconds[pass][5] = timeSeconds(repeats, [&] {
+            slots.clear();
+            ScanKernels::filterInRange(years.data(), count, 2020, 2024, slots);
+        });
+        r.yearRows = slots.size();
+    }
+    ScanKernels::useScalar(false);
+
+    for (int k = 0; k < 6; k++) {
+        ostringstream speedup;
+        speedup << fixed << setprecision(1) << seconds[1][k] / seconds[0][k] << "x";
+        cout << setw(30) << labels[k] << setw(16) << formatRate(bytes[k], seconds[0][k]) << setw(16)
+             << formatRate(bytes[k], seconds[1][k]) << speedup.str() << endl;
+    }
+
+    const Results& a = results[0];
+    const Results& b = results[1];
+    bool same = a.ratings.count == b.ratings.count && a.ratings.min == b.ratings.min &&
+                a.ratings.max == b.ratings.max && a.ratings.sum == b.ratings.sum && a.years.count == b.years.count &&
+                a.years.min == b.years.min && a.years.max == b.years.max && a.years.sum == b.years.sum &&
+                a.ratingCount == b.ratingCount && a.yearCount == b.yearCount && a.ratingRows == b.ratingRows &&
+                a.yearRows == b.yearRows;
+    cout << "Results identical across implementations: " << (same ? "yes" : "NO") << endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include "LanguageDictionary.h"
+#include "Movie.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+struct LanguageEntry
+{
+    std::string name;
+    std::string foldedName;
+};
+
+// Dictionary storage. Entries live in chunks that are never moved or
+// freed while the process runs: chunk c holds FIRST_CHUNK << c entries,
+// so a few dozen chunk pointers cover every possible ID. Interning fills
+// the next entry and then publishes it by bumping 'count', which lets
+// getName / getFoldedName read without taking the mutex. The mutex only
+// serializes interning and guards the name -> ID map.
+struct LanguageTable
+{
+    static const int FIRST_CHUNK = 64;
+    static const int MAX_CHUNKS = 26; // 64 << 26 entries in all, past INT_MAX
+
+    std::atomic<LanguageEntry *> chunks[MAX_CHUNKS];
+    std::atomic<int> count;                   // Entries published
+    std::unordered_map<std::string, int> ids; // Lowercase name -> ID
+    std::mutex lock;
+
+    LanguageTable() : count(0)
+    {
+        for (int c = 0; c < MAX_CHUNKS; c++)
+        {
+            chunks[c].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~LanguageTable()
+    {
+        for (int c = 0; c < MAX_CHUNKS; c++)
+        {
+            delete[] chunks[c].load(std::memory_order_relaxed);
+        }
+    }
+
+    LanguageTable(const LanguageTable &) = delete;
+    LanguageTable &operator=(const LanguageTable &) = delete;
+
+    // Chunk and position within it of an ID
+    static void locate(int id, int &chunk, int &offset)
+    {
+        chunk = 0;
+        offset = id;
+        for (int size = FIRST_CHUNK; offset >= size; size <<= 1)
+        {
+            offset -= size;
+            chunk++;
+        }
+    }
+
+    // Entry of a published ID: the acquire load pairs with intern's
+    // release, so the entry's strings are fully written when read here
+    const LanguageEntry &entry(int id) const
+    {
+        count.load(std::memory_order_acquire);
+        int chunk, offset;
+        locate(id, chunk, offset);
+        return chunks[chunk].load(std::memory_order_relaxed)[offset];
+    }
+};
+
+// Construct on first use so other static initializers can intern safely
+static LanguageTable &table()
+{
+    static LanguageTable instance;
+    return instance;
+}
+
+int LanguageDictionary::intern(TextView language)
+{
+    LanguageTable &t = table();
+    std::string folded = Movie::foldCase(language);
+
+    std::lock_guard<std::mutex> guard(t.lock);
+    std::unordered_map<std::string, int>::const_iterator it = t.ids.find(folded);
+    if (it != t.ids.end())
+    {
+        return it->second;
+    }
+
+    int id = t.count.load(std::memory_order_relaxed);
+    int chunk, offset;
+    LanguageTable::locate(id, chunk, offset);
+    LanguageEntry *entries = t.chunks[chunk].load(std::memory_order_relaxed);
+    if (!entries)
+    {
+        entries = new LanguageEntry[static_cast<size_t>(LanguageTable::FIRST_CHUNK) << chunk];
+        t.chunks[chunk].store(entries, std::memory_order_relaxed);
+    }
+    entries[offset].name = language.str();
+    entries[offset].foldedName = folded;
+    t.ids[folded] = id;
+    t.count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+int LanguageDictionary::find(TextView language)
+{
+    LanguageTable &t = table();
+    std::string folded = Movie::foldCase(language);
+
+    std::lock_guard<std::mutex> guard(t.lock);
+    std::unordered_map<std::string, int>::const_iterator it = t.ids.find(folded);
+    return it != t.ids.end() ? it->second : -1;
+}
+
+const std::string &LanguageDictionary::getName(int id)
+{
+    return table().entry(id).name;
+}
+
+const std::string &LanguageDictionary::getFoldedName(int id)
+{
+    return table().entry(id).foldedName;
+}
+
+int LanguageDictionary::size()
+{
+    return table().count.load(std::memory_order_acquire);
+}
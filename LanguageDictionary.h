@@ -0,0 +1,31 @@
+#ifndef LANGUAGEDICTIONARY_H
+#define LANGUAGEDICTIONARY_H
+
+#include "StringPool.h"
+#include <string>
+
+// Process-wide table of interned language names. Each distinct language
+// (compared case-insensitively) is stored once and identified by a small
+// integer ID, so movies only carry the ID and language filters become
+// integer comparisons. The spelling seen first is the one displayed.
+// Interning and find() take a mutex; getName, getFoldedName and size do
+// not, so rendering and sorting by language never contend with each other
+// or with loads that intern new languages.
+class LanguageDictionary
+{
+public:
+    // Return the ID for a language, adding it if it is new
+    static int intern(TextView language);
+
+    // Return the ID for a language, or -1 if it has never been interned
+    static int find(TextView language);
+
+    // Spelling and lowercase form of an interned language
+    static const std::string &getName(int id);
+    static const std::string &getFoldedName(int id);
+
+    // Number of languages interned so far (IDs are 0 .. size-1)
+    static int size();
+};
+
+#endif // LANGUAGEDICTIONARY_H
@@ -0,0 +1,106 @@
+// Microbenchmark for filtering movies by language.
+//
+// Builds a synthetic catalog with languages of very different frequency
+// and times, per language asked for (in varying case):
+//   - displayMoviesByLanguage, with its table written to a null stream
+//   - the filter alone: runQuery with a language predicate
+//   - Movie::isLanguage on every movie (the precomputed lowercase key)
+//   - lowercasing both sides for every movie, which is what each
+//     comparison cost before movies kept their folded forms
+// The query result cache is off, so every call does the full work.
+//
+// Usage: LanguageFilterBenchmark [movies] [repeats]
+//        (defaults: 100000 movies, 20 repeats)
+
+#include "MovieDatabase.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Milliseconds per call of fn, averaged over 'repeats' calls
+template <typename Fn>
+double timeMs(int repeats, Fn fn) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        fn();
+    }
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / repeats;
+}
+
+string formatMs(double ms) {
+    ostringstream cell;
+    cell << fixed << setprecision(3) << ms << " ms";
+    return cell.str();
+}
+
+// An output stream that discards everything
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) { return c; }
+    streamsize xsputn(const char*, streamsize count) { return count; }
+};
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 20;
+
+    // Roughly 70% English, 20% French, 9% Japanese, 1% Korean
+    MovieDatabase database;
+    database.reserve(count);
+    srand(5);
+    for (int id = 1; id <= count; id++) {
+        int pick = rand() % 100;
+        const char* language = pick < 70 ? "English" : pick < 90 ? "French" : pick < 99 ? "Japanese" : "Korean";
+        database.emplaceMovie("Movie title number " + to_string(id), id, 1900 + rand() % 125, language,
+                              (rand() % 91 + 10) / 10.0);
+    }
+    database.setQueryCacheCapacity(0, 0);
+    vector<const Movie*> all;
+    database.runQuery(MovieQuery(), all);
+
+    const char* asked[] = {"ENGLISH", "french", "Korean", "Klingon"};
+    cout << "Catalog: " << count << " movies" << endl << endl;
+    cout << left << setw(10) << "Language" << setw(9) << "matches" << setw(26) << "displayMoviesByLanguage"
+         << setw(16) << "runQuery" << setw(16) << "isLanguage" << "lowercase per row" << endl;
+
+    NullBuffer nothing;
+    for (int l = 0; l < 4; l++) {
+        string language = asked[l];
+        int matches = database.getLanguageCount(language);
+
+        streambuf* console = cout.rdbuf(&nothing);
+        double display = timeMs(repeats, [&] { database.displayMoviesByLanguage(language); });
+        cout.rdbuf(console);
+
+        vector<const Movie*> rows;
+        double query = timeMs(repeats, [&] { database.runQuery(MovieQuery().language(language), rows); });
+
+        size_t found = 0;
+        double folded = timeMs(repeats, [&] {
+            for (size_t i = 0; i < all.size(); i++) {
+                found += all[i]->isLanguage(language);
+            }
+        });
+
+        double lowered = timeMs(repeats, [&] {
+            for (size_t i = 0; i < all.size(); i++) {
+                found += Movie::foldCase(all[i]->getLanguage()) == Movie::foldCase(language);
+            }
+        });
+
+        cout << setw(10) << language << setw(9) << matches << setw(26) << formatMs(display) << setw(16)
+             << formatMs(query) << setw(16) << formatMs(folded) << formatMs(lowered) << endl;
+        if (found != 2 * static_cast<size_t>(matches) * repeats || rows.size() != static_cast<size_t>(matches)) {
+            cout << "  MISMATCH: filters disagree on " << language << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
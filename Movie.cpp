@@ -1,32 +1,156 @@
 #include "Movie.h"
+#include "LanguageDictionary.h"
 #include <iostream>
-#include <iomanip>
+#include <cctype>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
 
 // Initialize static member
 int Movie::displayStyle = 0; // Default to stars/bars
 
+// Text of a movie with no name: two empty strings, shared and never freed
+static const char EMPTY_TEXT[2] = {'\0', '\0'};
+
 // Default constructor initializes everything to default values
-Movie::Movie() : name(""), id(0), year(0), language(""), rating(0.0) {}
+Movie::Movie() : text(EMPTY_TEXT), nameLength(0), ownsText(false), id(0), year(0),
+                 languageId(LanguageDictionary::intern("")), rating(0.0) {}
 
 // Constructor that takes all movie details as parameters
-Movie::Movie(const std::string& name, int id, int year, const std::string& language, double rating)
-    : name(name), id(id), year(year), language(language), rating(rating) {
-    
+Movie::Movie(TextView name, int id, int year, TextView language, double rating)
+    : text(EMPTY_TEXT), nameLength(0), ownsText(false), id(id), year(year),
+      languageId(LanguageDictionary::intern(language)), rating(rating) {
+    setText(name.data(), name.size(), nullptr);
+    clampFields();
+}
+
+// Constructor for movies loaded straight into a database's string pool
+Movie::Movie(StringPool& pool, TextView name, int id, int year, int languageId, double rating)
+    : text(EMPTY_TEXT), nameLength(0), ownsText(false), id(id), year(year), languageId(languageId), rating(rating) {
+    setText(name.data(), name.size(), &pool);
+    clampFields();
+}
+
+Movie::Movie(const Movie& other)
+    : text(EMPTY_TEXT), nameLength(0), ownsText(false), id(other.id), year(other.year),
+      languageId(other.languageId), rating(other.rating) {
+    setText(other.text, other.nameLength, nullptr);
+}
+
+Movie::Movie(const Movie& other, StringPool& pool)
+    : text(EMPTY_TEXT), nameLength(0), ownsText(false), id(other.id), year(other.year),
+      languageId(other.languageId), rating(other.rating) {
+    setText(other.text, other.nameLength, &pool);
+}
+
+Movie::Movie(Movie&& other) noexcept
+    : text(other.text), nameLength(other.nameLength), ownsText(other.ownsText), id(other.id), year(other.year),
+      languageId(other.languageId), rating(other.rating) {
+    other.text = EMPTY_TEXT;
+    other.nameLength = 0;
+    other.ownsText = false;
+}
+
+Movie& Movie::operator=(const Movie& other) {
+    if (this != &other) {
+        setText(other.text, other.nameLength, nullptr);
+        id = other.id;
+        year = other.year;
+        languageId = other.languageId;
+        rating = other.rating;
+    }
+    return *this;
+}
+
+Movie& Movie::operator=(Movie&& other) noexcept {
+    if (this != &other) {
+        releaseText();
+        text = other.text;
+        nameLength = other.nameLength;
+        ownsText = other.ownsText;
+        id = other.id;
+        year = other.year;
+        languageId = other.languageId;
+        rating = other.rating;
+        other.text = EMPTY_TEXT;
+        other.nameLength = 0;
+        other.ownsText = false;
+    }
+    return *this;
+}
+
+Movie::~Movie() {
+    releaseText();
+}
+
+// Build "name\0folded\0" in a new block, then drop the old one
+void Movie::setText(const char* name, size_t length, StringPool* pool) {
+    const char* previous = text;
+    bool ownedPrevious = ownsText;
+    if (length == 0) {
+        text = EMPTY_TEXT;
+        ownsText = false;
+    } else {
+        char* block = pool ? pool->allocate(2 * length + 2) : new char[2 * length + 2];
+        std::memcpy(block, name, length);
+        block[length] = '\0';
+        for (size_t i = 0; i < length; i++) {
+            block[length + 1 + i] = static_cast<char>(tolower(static_cast<unsigned char>(name[i])));
+        }
+        block[2 * length + 1] = '\0';
+        text = block;
+        ownsText = pool == nullptr;
+    }
+    nameLength = static_cast<uint32_t>(length);
+    if (ownedPrevious) {
+        delete[] previous; // Freed last: 'name' may point into it
+    }
+}
+
+void Movie::releaseText() {
+    if (ownsText) {
+        delete[] text;
+    }
+    text = EMPTY_TEXT;
+    nameLength = 0;
+    ownsText = false;
+}
+
+void Movie::clampFields() {
     // Make sure rating stays between 1.0 and 10.0
-    if (this->rating < 1.0) this->rating = 1.0;
-    if (this->rating > 10.0) this->rating = 10.0;
+    if (rating < 1.0) rating = 1.0;
+    if (rating > 10.0) rating = 10.0;
     
     // Validate year to be reasonable (first film was 1888, future limit 2030)
-    if (this->year < 1888) this->year = 1888;
-    if (this->year > 2030) this->year = 2030;
+    if (year < 1888) year = 1888;
+    if (year > 2030) year = 2030;
     
     // ID should not be negative
-    if (this->id < 0) this->id = 0;
+    if (id < 0) id = 0;
+}
+
+// Move the text into a pool
+void Movie::storeTextIn(StringPool& pool) {
+    setText(text, nameLength, &pool);
+}
+
+bool Movie::isPooled() const {
+    return !ownsText && text != EMPTY_TEXT;
+}
+
+// Bytes taken by the name and its lowercase copy
+size_t Movie::getTextBytes() const {
+    return nameLength == 0 ? 0 : 2 * static_cast<size_t>(nameLength) + 2;
 }
 
 // Return the movie name
 std::string Movie::getName() const {
-    return name;
+    return std::string(text, nameLength);
+}
+
+// Return a view of the movie name
+TextView Movie::getNameView() const {
+    return TextView(text, nameLength);
 }
 
 // Return the movie ID
@@ -40,8 +164,13 @@ int Movie::getYear() const {
 }
 
 // Return the movie language
-std::string Movie::getLanguage() const {
-    return language;
+const std::string& Movie::getLanguage() const {
+    return LanguageDictionary::getName(languageId);
+}
+
+// Return the interned language ID
+int Movie::getLanguageId() const {
+    return languageId;
 }
 
 // Return the rating
@@ -49,9 +178,19 @@ double Movie::getRating() const {
     return rating;
 }
 
+// Return the lowercase name used for case-insensitive matching
+TextView Movie::getFoldedName() const {
+    return TextView(text + nameLength + 1, nameLength);
+}
+
+// Return the lowercase language used for case-insensitive matching
+const std::string& Movie::getFoldedLanguage() const {
+    return LanguageDictionary::getFoldedName(languageId);
+}
+
 // Update the movie name
-void Movie::setName(const std::string& name) {
-    this->name = name;
+void Movie::setName(TextView name, StringPool* pool) {
+    setText(name.data(), name.size(), pool);
 }
 
 // Update the movie ID
@@ -65,8 +204,8 @@ void Movie::setYear(int year) {
 }
 
 // Update the language
-void Movie::setLanguage(const std::string& language) {
-    this->language = language;
+void Movie::setLanguage(TextView language) {
+    languageId = LanguageDictionary::intern(language);
 }
 
 // Update the rating (only accepts 1.0-10.0)
@@ -88,68 +227,209 @@ int Movie::getDisplayStyle() {
     return displayStyle;
 }
 
-// Print movie information in a nice format
-void Movie::displayInfo() const {
-    std::cout << std::left << std::setw(5) << id 
-              << std::setw(50) << name 
-              << std::setw(6) << year 
-              << std::setw(15) << language;
-    
-    // Show rating based on current display style
-    std::cout << "[";
-    int stars = (int)(rating); // Full stars
+// Append text padded with spaces to 'width' (like std::left << std::setw)
+static void appendPadded(std::string& out, const char* text, size_t length, size_t width) {
+    out.append(text, length);
+    if (length < width) out.append(width - length, ' ');
+}
+
+// Write a non-negative integer's digits; returns the length
+static int formatInt(char* out, int value) {
+    char digits[12];
+    int length = 0;
+    unsigned magnitude = value < 0 ? 0u - static_cast<unsigned>(value) : static_cast<unsigned>(value);
+    do {
+        digits[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    int written = 0;
+    if (value < 0) out[written++] = '-';
+    while (length > 0) out[written++] = digits[--length];
+    return written;
+}
+
+// Format a rating like "%.1f". Ratings are almost always whole tenths,
+// which are written directly; anything else goes through snprintf so the
+// rounding stays exactly printf's.
+static int formatRating(char* out, size_t size, double rating) {
+    double tenths = rating * 10.0;
+    long whole = static_cast<long>(tenths + 0.5);
+    if (rating >= 0.0 && rating < 1000000.0 && std::fabs(tenths - whole) < 1e-6) {
+        int length = formatInt(out, static_cast<int>(whole / 10));
+        out[length++] = '.';
+        out[length++] = static_cast<char>('0' + whole % 10);
+        return length;
+    }
+    return snprintf(out, size, "%.1f", rating);
+}
+
+// Rating bars for every style and star count, e.g. "[*******---] ",
+// built once so a row never has to assemble them character by character
+struct RatingBars {
+    std::string bars[5][11];
     
-    switch(displayStyle) {
-        case 0: // Stars/Bars [**********] [*******---]
-            for (int i = 0; i < stars; i++) std::cout << "*";
-            for (int i = stars; i < 10; i++) std::cout << "-";
-            std::cout << "] " << std::fixed << std::setprecision(1) << rating << "/10";
-            break;
-            
-        case 1: // Blocks [##########] [#######...]
-            for (int i = 0; i < stars; i++) std::cout << "#";
-            for (int i = stars; i < 10; i++) std::cout << ".";
-            std::cout << "] " << std::fixed << std::setprecision(1) << rating << "/10";
-            break;
-            
-        case 2: // Circles [oooooooooo] [ooooooo...]
-            for (int i = 0; i < stars; i++) std::cout << "o";
-            for (int i = stars; i < 10; i++) std::cout << ".";
-            std::cout << "] " << std::fixed << std::setprecision(1) << rating << "/10";
-            break;
-            
-        case 3: // Plus Signs [++++++++++] [+++++++   ]
-            for (int i = 0; i < stars; i++) std::cout << "+";
-            for (int i = stars; i < 10; i++) std::cout << " ";
-            std::cout << "] " << std::fixed << std::setprecision(1) << rating << "/10";
-            break;
-            
-        case 4: // Numbers Only
-            std::cout << std::fixed << std::setprecision(1) << rating << "/10.0]";
-            break;
-            
-        default: // Fallback to stars
-            for (int i = 0; i < stars; i++) std::cout << "*";
-            for (int i = stars; i < 10; i++) std::cout << "-";
-            std::cout << "] " << std::fixed << std::setprecision(1) << rating << "/10";
-            break;
+    RatingBars() {
+        const char marks[4][2] = {{'*', '-'}, {'#', '.'}, {'o', '.'}, {'+', ' '}};
+        for (int s = 0; s < 4; s++) {
+            for (int k = 0; k <= 10; k++) {
+                bars[s][k] = "[" + std::string(k, marks[s][0]) + std::string(10 - k, marks[s][1]) + "] ";
+            }
+        }
+        for (int k = 0; k <= 10; k++) {
+            bars[4][k] = "["; // Numbers only: the rating follows directly
+        }
     }
+};
+
+static const std::string& ratingBar(int style, int stars) {
+    static const RatingBars table; // Thread-safe one-time construction
+    return table.bars[style][stars];
+}
+
+// Append this movie's table row (with trailing newline) to a buffer
+void Movie::appendInfo(std::string& out) const {
+    char number[32];
+    int length = formatInt(number, id);
+    appendPadded(out, number, length, 5);
+    appendPadded(out, text, nameLength, 50);
+    length = formatInt(number, year);
+    appendPadded(out, number, length, 6);
+    const std::string& language = LanguageDictionary::getName(languageId);
+    appendPadded(out, language.data(), language.size(), 15);
     
-    std::cout << std::endl;
+    // Show rating based on current display style (unknown styles use stars)
+    int style = (displayStyle >= 0 && displayStyle <= 4) ? displayStyle : 0;
+    int stars = (int)(rating); // Full stars
+    if (stars < 0) stars = 0;
+    if (stars > 10) stars = 10;
+    out += ratingBar(style, stars);
+    length = formatRating(number, sizeof(number), rating);
+    out.append(number, length);
+    out += (style == 4) ? "/10.0]\n" : "/10\n";
+}
+
+// Write a rating exactly: whole tenths as "8.1", anything else with
+// enough digits to read back the same double
+static int formatExactRating(char* out, size_t size, double rating) {
+    long whole = static_cast<long>(rating * 10.0 + 0.5);
+    if (rating >= 0.0 && rating < 1000000.0 && static_cast<double>(whole) / 10.0 == rating) {
+        return formatRating(out, size, rating);
+    }
+    return snprintf(out, size, "%.17g", rating);
+}
+
+// Append a CSV field, quoted only when it holds a comma, quote or line break
+static void appendCsvField(std::string& out, TextView text) {
+    const char* data = text.data();
+    size_t size = text.size();
+    bool special = false;
+    for (size_t i = 0; i < size && !special; i++) {
+        special = data[i] == ',' || data[i] == '"' || data[i] == '\r' || data[i] == '\n';
+    }
+    if (!special) {
+        out.append(data, size);
+        return;
+    }
+    out += '"';
+    size_t start = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == '"') {
+            out.append(data + start, i - start + 1);
+            out += '"'; // Quotes are doubled
+            start = i + 1;
+        }
+    }
+    out.append(data + start, size - start);
+    out += '"';
+}
+
+// Append a JSON string literal; bytes above 0x7f pass through unchanged
+static void appendJsonString(std::string& out, TextView text) {
+    static const char hex[] = "0123456789abcdef";
+    const char* data = text.data();
+    out += '"';
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out.append(data + start, i - start);
+        start = i + 1;
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xf];
+        }
+    }
+    out.append(data + start, text.size() - start);
+    out += '"';
+}
+
+// Append "id,name,year,language,rating" and a newline
+void Movie::appendCsv(std::string& out) const {
+    char number[32];
+    out.append(number, formatInt(number, id));
+    out += ',';
+    appendCsvField(out, getNameView());
+    out += ',';
+    out.append(number, formatInt(number, year));
+    out += ',';
+    appendCsvField(out, LanguageDictionary::getName(languageId));
+    out += ',';
+    out.append(number, formatExactRating(number, sizeof(number), rating));
+    out += '\n';
+}
+
+// Append {"id":..,"name":..,"year":..,"language":..,"rating":..} and a newline
+void Movie::appendJson(std::string& out) const {
+    char number[32];
+    out += "{\"id\":";
+    out.append(number, formatInt(number, id));
+    out += ",\"name\":";
+    appendJsonString(out, getNameView());
+    out += ",\"year\":";
+    out.append(number, formatInt(number, year));
+    out += ",\"language\":";
+    appendJsonString(out, LanguageDictionary::getName(languageId));
+    out += ",\"rating\":";
+    out.append(number, formatExactRating(number, sizeof(number), rating));
+    out += "}\n";
+}
+
+// Print movie information in a nice format
+void Movie::displayInfo() const {
+    std::string line;
+    line.reserve(128);
+    appendInfo(line);
+    std::cout << line;
 }
 
 // Helper function to check if this movie is in a particular language (case-insensitive)
 bool Movie::isLanguage(const std::string& lang) const {
-    std::string lowerLang1 = language;
-    std::string lowerLang2 = lang;
+    const std::string& foldedLanguage = getFoldedLanguage();
+    if (lang.length() != foldedLanguage.length()) {
+        return false;
+    }
     
-    // Convert both to lowercase for case-insensitive comparison
-    for (size_t i = 0; i < lowerLang1.length(); i++) {
-        lowerLang1[i] = tolower(lowerLang1[i]);
+    // Compare against the stored lowercase language one character at a time
+    for (size_t i = 0; i < lang.length(); i++) {
+        if (tolower(static_cast<unsigned char>(lang[i])) != static_cast<unsigned char>(foldedLanguage[i])) {
+            return false;
+        }
     }
-    for (size_t i = 0; i < lowerLang2.length(); i++) {
-        lowerLang2[i] = tolower(lowerLang2[i]);
+    return true;
+}
+
+// Convert a string to lowercase
+std::string Movie::foldCase(TextView text) {
+    std::string folded = text.str();
+    for (size_t i = 0; i < folded.length(); i++) {
+        folded[i] = tolower(static_cast<unsigned char>(folded[i]));
     }
-    
-    return lowerLang1 == lowerLang2;
+    return folded;
 }
@@ -1,38 +1,87 @@
 #ifndef MOVIE_H
 #define MOVIE_H
 
+#include "StringPool.h"
 #include <string>
+#include <cstdint>
 
 // Movie class represents a single movie with its properties
 class Movie {
 private:
+    // The name followed by its lowercase copy, both NUL-terminated
+    // ("Name\0name\0"), in one block: the movie's own heap block, or a
+    // StringPool's when ownsText is false. The lowercase copy is kept in
+    // sync so comparisons never have to lowercase on the fly.
+    const char* text;
+    uint32_t nameLength;
+    bool ownsText;
+    
     // Movie attributes
-    std::string name;
     int id;
     int year;
-    std::string language;
+    int languageId; // Interned language (see LanguageDictionary)
     double rating; // Rating from 1.0 to 10.0
     
     // Static variable to hold the current display style
     static int displayStyle; // 0=stars, 1=blocks, 2=circles, 3=plus, 4=numbers
     
+    // Replace the text with a copy of 'name' (in 'pool' if given)
+    void setText(const char* name, size_t length, StringPool* pool);
+    void releaseText();
+    
+    // Keep year, rating and ID in their valid ranges
+    void clampFields();
+    
 public:
-    // Constructors
+    // Constructors (the name is copied straight from the view, so
+    // character data from a file or buffer needs no temporary string)
     Movie();
-    Movie(const std::string& name, int id, int year, const std::string& language, double rating);
+    Movie(TextView name, int id, int year, TextView language, double rating);
+    
+    // Build a movie whose text lives in 'pool' (the movie must not
+    // outlive it); languageId is an already interned language
+    Movie(StringPool& pool, TextView name, int id, int year, int languageId, double rating);
+    
+    // Copies always own their text, so they never depend on a pool;
+    // moves keep it where it is
+    Movie(const Movie& other);
+    Movie(Movie&& other) noexcept;
+    Movie& operator=(const Movie& other);
+    Movie& operator=(Movie&& other) noexcept;
+    ~Movie();
+    
+    // Copy of 'other' with its text placed in 'pool'
+    Movie(const Movie& other, StringPool& pool);
     
-    // Getters to access private data
+    // Move the text into 'pool' (the movie must not outlive it)
+    void storeTextIn(StringPool& pool);
+    
+    // True when the text lives in a StringPool; getTextBytes is its size
+    bool isPooled() const;
+    size_t getTextBytes() const;
+    
+    // Getters to access private data. getName returns a copy; loops
+    // should use getNameView, which never allocates.
     std::string getName() const;
     int getId() const;
     int getYear() const;
-    std::string getLanguage() const;
+    const std::string& getLanguage() const;
+    int getLanguageId() const;
     double getRating() const;
     
-    // Setters to modify private data
-    void setName(const std::string& name);
+    // Views of the stored name and its lowercase copy (no copying)
+    TextView getNameView() const;
+    TextView getFoldedName() const;
+    const std::string& getFoldedLanguage() const;
+    
+    // Setters to modify private data (a pooled movie's new name is
+    // stored in 'pool' when given, else in the movie's own block). The
+    // name is copied into the movie's text block either way, so setters
+    // take views rather than strings to move from.
+    void setName(TextView name, StringPool* pool = nullptr);
     void setId(int id);
     void setYear(int year);
-    void setLanguage(const std::string& language);
+    void setLanguage(TextView language);
     void setRating(double rating);
     
     // Static method to set display style for all movies
@@ -42,8 +91,19 @@ public:
     // Display movie information
     void displayInfo() const;
     
+    // Append the same table row to a buffer instead of printing it
+    void appendInfo(std::string& out) const;
+    
+    // Append this movie as one CSV record / one JSON object, with a
+    // trailing newline (used by MovieExporter)
+    void appendCsv(std::string& out) const;
+    void appendJson(std::string& out) const;
+    
     // Check if movie is in a specific language
     bool isLanguage(const std::string& lang) const;
+    
+    // Lowercase copy of a string (the form stored in the folded keys)
+    static std::string foldCase(TextView text);
 };
 
 #endif // MOVIE_H
@@ -0,0 +1,444 @@
+#include "MovieBatch.h"
+#include <cstdlib>
+#include <utility>
+
+// Flush the result buffer once it holds this many bytes
+static const size_t RESULT_BUFFER_BYTES = 64 * 1024;
+
+// Strip spaces and tabs from both ends of a field
+static std::string trimField(const std::string &text)
+{
+    size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos)
+    {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+// Parse a whole field as an integer
+static bool parseInt(const std::string &field, int &value)
+{
+    std::string text = trimField(field);
+    if (text.empty())
+    {
+        return false;
+    }
+    char *end;
+    long result = std::strtol(text.c_str(), &end, 10);
+    if (*end != '\0' || result < -2147483647L || result > 2147483647L)
+    {
+        return false;
+    }
+    value = static_cast<int>(result);
+    return true;
+}
+
+// Parse a whole field as a number
+static bool parseDouble(const std::string &field, double &value)
+{
+    std::string text = trimField(field);
+    if (text.empty())
+    {
+        return false;
+    }
+    char *end;
+    value = std::strtod(text.c_str(), &end);
+    return *end == '\0' && value == value; // Rejects trailing junk and NaN
+}
+
+// Parse "low-high"
+template <typename T>
+static bool parseRange(const std::string &text, T &low, T &high, bool (*parse)(const std::string &, T &))
+{
+    size_t dash = text.find('-', 1);
+    return dash != std::string::npos && parse(text.substr(0, dash), low) && parse(text.substr(dash + 1), high);
+}
+
+// Validate and store the name/year/language/rating fields of ADD and UPDATE
+static bool parseMovieFields(const std::vector<std::string> &fields, size_t first, BatchCommand &command,
+                             std::string &error)
+{
+    command.name = fields[first];
+    command.language = trimField(fields[first + 2]);
+    if (command.name.empty() || command.language.empty())
+    {
+        error = "name and language must not be empty";
+        return false;
+    }
+    if (!parseInt(fields[first + 1], command.year) || command.year < 1888 || command.year > 2030)
+    {
+        error = "year must be a whole number from 1888 to 2030";
+        return false;
+    }
+    if (!parseDouble(fields[first + 3], command.rating) || command.rating < 1.0 || command.rating > 10.0)
+    {
+        error = "rating must be a number from 1.0 to 10.0";
+        return false;
+    }
+    return true;
+}
+
+// Parse the key=value filters of a QUERY
+static bool parseQuery(const std::vector<std::string> &fields, BatchCommand &command, std::string &error)
+{
+    for (size_t i = 1; i < fields.size(); i++)
+    {
+        size_t equals = fields[i].find('=');
+        std::string key = trimField(fields[i].substr(0, equals));
+        std::string value = equals == std::string::npos ? "" : fields[i].substr(equals + 1);
+        bool valid = true;
+        if (equals == std::string::npos)
+        {
+            valid = false;
+        }
+        else if (key == "name")
+        {
+            command.query.nameContains(std::move(value));
+        }
+        else if (key == "language")
+        {
+            command.query.language(trimField(value));
+        }
+        else if (key == "years")
+        {
+            int from, to;
+            valid = parseRange(trimField(value), from, to, parseInt);
+            if (valid)
+            {
+                command.query.years(from, to);
+            }
+        }
+        else if (key == "ratings")
+        {
+            double low, high;
+            valid = parseRange(trimField(value), low, high, parseDouble);
+            if (valid)
+            {
+                command.query.ratings(low, high);
+            }
+        }
+        else if (key == "order")
+        {
+            std::string order = Movie::foldCase(trimField(value));
+            if (order == "rating")
+            {
+                command.query.orderBy(MovieQuery::ORDER_RATING);
+            }
+            else if (order == "year")
+            {
+                command.query.orderBy(MovieQuery::ORDER_YEAR);
+            }
+            else if (order == "name")
+            {
+                command.query.orderBy(MovieQuery::ORDER_NAME);
+            }
+            else if (order == "id")
+            {
+                command.query.orderBy(MovieQuery::ORDER_ID);
+            }
+            else
+            {
+                valid = false;
+            }
+        }
+        else if (key == "limit")
+        {
+            int limit;
+            valid = parseInt(value, limit) && limit >= 0;
+            if (valid)
+            {
+                command.query.limit(static_cast<size_t>(limit));
+            }
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            error = "bad query filter (expected name=, language=, years=FROM-TO, ratings=MIN-MAX, order=, limit=)";
+            return false;
+        }
+    }
+    return true;
+}
+
+static const char *operationName(BatchCommand::Type type)
+{
+    switch (type)
+    {
+    case BatchCommand::ADD:
+        return "add";
+    case BatchCommand::UPDATE:
+        return "update";
+    case BatchCommand::REMOVE:
+        return "delete";
+    default:
+        return "query";
+    }
+}
+
+MovieBatch::MovieBatch(MovieDatabase &database, std::ostream &out)
+    : database(database), out(out), added(0), updated(0), removed(0), queries(0), failedLine(0)
+{
+}
+
+bool MovieBatch::parseLine(const std::string &text, int line, BatchCommand &command, bool &skip,
+                           std::string &error)
+{
+    std::string content = text;
+    if (!content.empty() && content[content.size() - 1] == '\r')
+    {
+        content.erase(content.size() - 1); // Scripts written on Windows
+    }
+    std::string trimmed = trimField(content);
+    skip = trimmed.empty() || trimmed[0] == '#';
+    if (skip)
+    {
+        return true;
+    }
+
+    std::vector<std::string> fields;
+    size_t start = 0;
+    size_t bar;
+    while ((bar = content.find('|', start)) != std::string::npos)
+    {
+        fields.push_back(content.substr(start, bar - start));
+        start = bar + 1;
+    }
+    fields.push_back(content.substr(start));
+
+    command = BatchCommand();
+    command.line = line;
+    command.id = 0;
+    command.year = 0;
+    command.rating = 0.0;
+
+    std::string operation = Movie::foldCase(trimField(fields[0]));
+    if (operation == "add")
+    {
+        command.type = BatchCommand::ADD;
+        if (fields.size() != 5 && fields.size() != 6)
+        {
+            error = "expected add|Name|Year|Language|Rating[|ID]";
+            return false;
+        }
+        if (fields.size() == 6 && (!parseInt(fields[5], command.id) || command.id <= 0))
+        {
+            error = "ID must be a positive whole number";
+            return false;
+        }
+        return parseMovieFields(fields, 1, command, error);
+    }
+    if (operation == "update")
+    {
+        command.type = BatchCommand::UPDATE;
+        if (fields.size() != 6)
+        {
+            error = "expected update|ID|Name|Year|Language|Rating";
+            return false;
+        }
+        if (!parseInt(fields[1], command.id))
+        {
+            error = "ID must be a whole number";
+            return false;
+        }
+        return parseMovieFields(fields, 2, command, error);
+    }
+    if (operation == "delete" || operation == "remove")
+    {
+        command.type = BatchCommand::REMOVE;
+        if (fields.size() != 2 || !parseInt(fields[1], command.id))
+        {
+            error = "expected delete|ID";
+            return false;
+        }
+        return true;
+    }
+    if (operation == "query")
+    {
+        command.type = BatchCommand::QUERY;
+        return parseQuery(fields, command, error);
+    }
+    error = "unknown command (expected add, update, delete or query)";
+    return false;
+}
+
+bool MovieBatch::run(std::istream &script)
+{
+    added = updated = removed = queries = 0;
+    failedLine = 0;
+
+    // Parse everything first so a typo near the end changes nothing
+    std::vector<BatchCommand> commands;
+    std::string text, error;
+    int line = 0;
+    while (std::getline(script, text))
+    {
+        line++;
+        BatchCommand command;
+        bool skip;
+        if (!parseLine(text, line, command, skip, error))
+        {
+            failedLine = line;
+            buffer += "{\"line\":";
+            buffer += std::to_string(line);
+            buffer += ",\"ok\":false,\"error\":\"";
+            buffer += error;
+            buffer += "\"}\n";
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+            out.flush();
+            return false;
+        }
+        if (!skip)
+        {
+            commands.push_back(std::move(command));
+        }
+    }
+
+    bool ok = true;
+    size_t first = 0;
+    for (size_t i = 0; i <= commands.size() && ok; i++)
+    {
+        if (i == commands.size() || commands[i].type == BatchCommand::QUERY)
+        {
+            ok = applyEdits(commands, first, i);
+            if (ok && i < commands.size())
+            {
+                queries++;
+                report(commands[i], true, 0, nullptr);
+            }
+            first = i + 1;
+        }
+    }
+    out.write(buffer.data(), buffer.size());
+    buffer.clear();
+    out.flush();
+    return ok;
+}
+
+bool MovieBatch::applyEdits(std::vector<BatchCommand> &commands, size_t first, size_t last)
+{
+    if (first == last)
+    {
+        return true;
+    }
+    std::vector<MovieEdit> edits(last - first);
+    for (size_t i = first; i < last; i++)
+    {
+        BatchCommand &command = commands[i];
+        MovieEdit &edit = edits[i - first];
+        edit.type = command.type == BatchCommand::ADD      ? MovieEdit::EDIT_ADD
+                    : command.type == BatchCommand::UPDATE ? MovieEdit::EDIT_UPDATE
+                                                           : MovieEdit::EDIT_REMOVE;
+        edit.id = command.id;
+        edit.name = std::move(command.name); // Results only need the line and ID
+        edit.year = command.year;
+        edit.language = std::move(command.language);
+        edit.rating = command.rating;
+    }
+
+    BatchResult result;
+    bool ok = database.applyBatch(edits, result);
+    size_t done = ok ? edits.size() : result.failedEdit;
+
+    // Everything before a failure would have succeeded on its own
+    for (size_t i = 0; i < done; i++)
+    {
+        const BatchCommand &command = commands[first + i];
+        if (command.type == BatchCommand::ADD)
+        {
+            added++;
+        }
+        else if (command.type == BatchCommand::UPDATE)
+        {
+            updated++;
+        }
+        else
+        {
+            removed++;
+        }
+        report(command, true, result.ids[i], nullptr);
+    }
+    if (!ok)
+    {
+        const BatchCommand &command = commands[first + done];
+        failedLine = command.line;
+        report(command, false, result.ids[done],
+               command.type == BatchCommand::ADD ? "a movie with this ID already exists" : "no movie with this ID");
+    }
+    return ok;
+}
+
+void MovieBatch::report(const BatchCommand &command, bool ok, int id, const char *error)
+{
+    buffer += "{\"line\":";
+    buffer += std::to_string(command.line);
+    buffer += ",\"op\":\"";
+    buffer += operationName(command.type);
+    buffer += ok ? "\",\"ok\":true" : "\",\"ok\":false";
+    if (command.type == BatchCommand::QUERY)
+    {
+        std::vector<const Movie *> results;
+        database.runQuery(command.query, results);
+        buffer += ",\"count\":";
+        buffer += std::to_string(results.size());
+        buffer += ",\"movies\":[";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            results[i]->appendJson(buffer);
+            buffer[buffer.size() - 1] = ','; // Replace the record's newline
+        }
+        if (!results.empty())
+        {
+            buffer.erase(buffer.size() - 1);
+        }
+        buffer += ']';
+    }
+    else
+    {
+        buffer += ",\"id\":";
+        buffer += std::to_string(id);
+    }
+    if (error)
+    {
+        buffer += ",\"error\":\"";
+        buffer += error;
+        buffer += '"';
+    }
+    buffer += "}\n";
+    if (buffer.size() >= RESULT_BUFFER_BYTES)
+    {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+int MovieBatch::getAdded() const
+{
+    return added;
+}
+
+int MovieBatch::getUpdated() const
+{
+    return updated;
+}
+
+int MovieBatch::getRemoved() const
+{
+    return removed;
+}
+
+int MovieBatch::getQueries() const
+{
+    return queries;
+}
+
+int MovieBatch::getFailedLine() const
+{
+    return failedLine;
+}
@@ -0,0 +1,89 @@
+#ifndef MOVIEBATCH_H
+#define MOVIEBATCH_H
+
+#include "MovieDatabase.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// One command of a batch script
+struct BatchCommand
+{
+    enum Type
+    {
+        ADD,
+        UPDATE,
+        REMOVE,
+        QUERY
+    };
+
+    Type type;
+    int line;             // Line number in the script (for results and errors)
+    int id;               // Movie ID (ADD: 0 = next free ID)
+    std::string name;     // ADD / UPDATE fields
+    int year;
+    std::string language;
+    double rating;
+    MovieQuery query;     // QUERY filters
+};
+
+// Runs a script of edits and queries against a database, for scripted
+// bulk loads. One command per line, fields separated by '|' (like
+// movies.txt); blank lines and lines starting with '#' are skipped:
+//
+//   add|Name|Year|Language|Rating[|ID]
+//   update|ID|Name|Year|Language|Rating
+//   delete|ID
+//   query[|name=text][|language=L][|years=FROM-TO][|ratings=MIN-MAX]
+//        [|order=rating/year/name/id][|limit=N]
+//
+// The whole script is parsed before anything is applied, and applying
+// stops at the first command that fails, so the caller can treat the
+// script as one transaction: persist once if run() succeeds, discard the
+// in-memory changes otherwise. Every command reports one JSON line:
+//
+//   {"line":3,"op":"add","ok":true,"id":51}
+//   {"line":4,"op":"query","ok":true,"count":1,"movies":[{...}]}
+//   {"line":5,"op":"delete","ok":false,"id":99,"error":"no movie with this ID"}
+class MovieBatch
+{
+private:
+    MovieDatabase &database;
+    std::ostream &out;
+    std::string buffer;        // Result lines waiting to be written
+    int added, updated, removed, queries;
+    int failedLine;            // Line of the command that stopped the run (0 = none)
+
+    // Apply commands [first, last) (edits only) with one applyBatch call;
+    // their names and languages are moved into the edits
+    bool applyEdits(std::vector<BatchCommand> &commands, size_t first, size_t last);
+
+    // Queue one result line, writing the buffer out once it is large
+    void report(const BatchCommand &command, bool ok, int id, const char *error);
+
+public:
+    MovieBatch(MovieDatabase &database, std::ostream &out);
+
+    // Parse one script line. Returns false with a message for a malformed
+    // line; 'skip' is set for blank and comment lines.
+    static bool parseLine(const std::string &text, int line, BatchCommand &command,
+                          bool &skip, std::string &error);
+
+    // Parse the whole script, then apply it. Each run of edits between
+    // queries goes to the database as one applyBatch call; queries see
+    // every edit above them. Returns false (after reporting the offending
+    // line) on the first error.
+    bool run(std::istream &script);
+
+    // What the last run did
+    int getAdded() const;
+    int getUpdated() const;
+    int getRemoved() const;
+    int getQueries() const;
+    int getFailedLine() const;
+
+    MovieBatch(const MovieBatch &) = delete;
+    MovieBatch &operator=(const MovieBatch &) = delete;
+};
+
+#endif // MOVIEBATCH_H
@@ -0,0 +1,159 @@
+#include "MovieColumns.h"
+#include <algorithm>
+
+MovieColumns::MovieColumns() : deadNameBytes(0)
+{
+}
+
+uint32_t MovieColumns::storeName(TextView foldedName)
+{
+    uint32_t offset = static_cast<uint32_t>(nameArena.size());
+    nameArena.insert(nameArena.end(), foldedName.data(), foldedName.data() + foldedName.size());
+    return offset;
+}
+
+// Copy live names into a fresh arena in slot order
+void MovieColumns::compactNames()
+{
+    std::vector<char> packed;
+    packed.reserve(nameArena.size() - deadNameBytes);
+    for (size_t i = 0; i < nameOffsets.size(); i++)
+    {
+        uint32_t offset = static_cast<uint32_t>(packed.size());
+        packed.insert(packed.end(), nameArena.begin() + nameOffsets[i],
+                      nameArena.begin() + nameOffsets[i] + nameLengths[i]);
+        nameOffsets[i] = offset;
+    }
+    nameArena.swap(packed);
+    deadNameBytes = 0;
+}
+
+// Add a slot at the end
+void MovieColumns::append(const Movie &movie)
+{
+    ids.push_back(movie.getId());
+    years.push_back(movie.getYear());
+    ratings.push_back(movie.getRating());
+    languageIds.push_back(movie.getLanguageId());
+    nameOffsets.push_back(storeName(movie.getFoldedName()));
+    nameLengths.push_back(static_cast<uint32_t>(movie.getFoldedName().size()));
+}
+
+// Refresh a slot after its movie changed
+void MovieColumns::assign(int slot, const Movie &movie)
+{
+    ids[slot] = movie.getId();
+    years[slot] = movie.getYear();
+    ratings[slot] = movie.getRating();
+    languageIds[slot] = movie.getLanguageId();
+
+    TextView name = movie.getFoldedName();
+    if (name.size() != nameLengths[slot] ||
+        !std::equal(name.data(), name.data() + name.size(), nameArena.begin() + nameOffsets[slot]))
+    {
+        deadNameBytes += nameLengths[slot];
+        nameOffsets[slot] = storeName(name);
+        nameLengths[slot] = static_cast<uint32_t>(name.size());
+        if (deadNameBytes > nameArena.size() / 2)
+        {
+            compactNames();
+        }
+    }
+}
+
+// Remove a slot, keeping the order of the rest
+void MovieColumns::erase(int slot)
+{
+    deadNameBytes += nameLengths[slot];
+    ids.erase(ids.begin() + slot);
+    years.erase(years.begin() + slot);
+    ratings.erase(ratings.begin() + slot);
+    languageIds.erase(languageIds.begin() + slot);
+    nameOffsets.erase(nameOffsets.begin() + slot);
+    nameLengths.erase(nameLengths.begin() + slot);
+    if (deadNameBytes > nameArena.size() / 2)
+    {
+        compactNames();
+    }
+}
+
+// Remove a slot by moving the last one into it
+void MovieColumns::swapRemove(int slot)
+{
+    deadNameBytes += nameLengths[slot];
+    size_t last = ids.size() - 1;
+    ids[slot] = ids[last];
+    years[slot] = years[last];
+    ratings[slot] = ratings[last];
+    languageIds[slot] = languageIds[last];
+    nameOffsets[slot] = nameOffsets[last];
+    nameLengths[slot] = nameLengths[last];
+
+    ids.pop_back();
+    years.pop_back();
+    ratings.pop_back();
+    languageIds.pop_back();
+    nameOffsets.pop_back();
+    nameLengths.pop_back();
+    if (deadNameBytes > nameArena.size() / 2)
+    {
+        compactNames();
+    }
+}
+
+void MovieColumns::clear()
+{
+    ids.clear();
+    years.clear();
+    ratings.clear();
+    languageIds.clear();
+    nameArena.clear();
+    nameOffsets.clear();
+    nameLengths.clear();
+    deadNameBytes = 0;
+}
+
+void MovieColumns::reserve(size_t count)
+{
+    ids.reserve(count);
+    years.reserve(count);
+    ratings.reserve(count);
+    languageIds.reserve(count);
+    nameOffsets.reserve(count);
+    nameLengths.reserve(count);
+}
+
+size_t MovieColumns::size() const
+{
+    return ids.size();
+}
+
+const std::vector<int> &MovieColumns::getIds() const
+{
+    return ids;
+}
+
+const std::vector<int> &MovieColumns::getYears() const
+{
+    return years;
+}
+
+const std::vector<double> &MovieColumns::getRatings() const
+{
+    return ratings;
+}
+
+const std::vector<int> &MovieColumns::getLanguageIds() const
+{
+    return languageIds;
+}
+
+const char *MovieColumns::getNameData(int slot) const
+{
+    return nameArena.data() + nameOffsets[slot];
+}
+
+int MovieColumns::getNameLength(int slot) const
+{
+    return static_cast<int>(nameLengths[slot]);
+}
@@ -0,0 +1,56 @@
+#ifndef MOVIECOLUMNS_H
+#define MOVIECOLUMNS_H
+
+#include "Movie.h"
+#include <vector>
+#include <cstdint>
+
+// Column-oriented (struct-of-arrays) copy of the movie table. Slot i of
+// every column describes the movie in slot i of MovieDatabase's array, so
+// scans over one field (max rating, latest year, language filter) walk a
+// single contiguous array instead of dragging whole Movie objects through
+// the cache. Lowercase names live back to back in one string arena.
+class MovieColumns
+{
+private:
+    std::vector<int> ids;
+    std::vector<int> years;
+    std::vector<double> ratings;
+    std::vector<int> languageIds;
+
+    std::vector<char> nameArena;         // Lowercase names, back to back
+    std::vector<uint32_t> nameOffsets;   // Start of each slot's name in the arena
+    std::vector<uint32_t> nameLengths;   // Length of each slot's name
+    size_t deadNameBytes;                // Arena bytes no slot points at any more
+
+    // Append a name to the arena and return its offset
+    uint32_t storeName(TextView foldedName);
+
+    // Rewrite the arena without dead bytes once they dominate
+    void compactNames();
+
+public:
+    MovieColumns();
+
+    // Mirror the edits MovieDatabase makes to its movie array
+    void append(const Movie &movie);
+    void assign(int slot, const Movie &movie);
+    void erase(int slot);      // Shift later slots down (order-preserving delete)
+    void swapRemove(int slot); // Move the last slot into 'slot' (O(1) delete)
+    void clear();
+    void reserve(size_t count);
+
+    size_t size() const;
+
+    // Contiguous columns, indexed by slot
+    const std::vector<int> &getIds() const;
+    const std::vector<int> &getYears() const;
+    const std::vector<double> &getRatings() const;
+    const std::vector<int> &getLanguageIds() const;
+
+    // Lowercase name of a slot, straight from the arena (not terminated)
+    const char *getNameData(int slot) const;
+    int getNameLength(int slot) const;
+};
+
+#endif // MOVIECOLUMNS_H
@@ -0,0 +1,29 @@
+#include "MovieCursor.h"
+
+// An exhausted cursor; MovieDatabase::openCursor returns live ones
+MovieCursor::MovieCursor() : lazyScan(false), finished(true)
+{
+    token.position = 0;
+    token.lastId = -1;
+    token.returned = 0;
+}
+
+bool MovieCursor::hasMore() const
+{
+    return !finished;
+}
+
+CursorToken MovieCursor::getToken() const
+{
+    return token;
+}
+
+size_t MovieCursor::getReturnedCount() const
+{
+    return token.returned;
+}
+
+const MovieQuery &MovieCursor::getQuery() const
+{
+    return query;
+}
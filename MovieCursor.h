@@ -0,0 +1,49 @@
+#ifndef MOVIECURSOR_H
+#define MOVIECURSOR_H
+
+#include "MovieQuery.h"
+#include <vector>
+
+// Where a cursor stopped: enough to pick up from the same spot later with
+// MovieDatabase::openCursor, even after the cursor itself is gone. If the
+// table was edited meanwhile, the cursor resumes after the last movie it
+// returned when that movie still exists, else at the old position.
+struct CursorToken
+{
+    size_t position; // Next slot (scans) or next list entry (sorted results)
+    int lastId;      // ID of the last movie returned, -1 before the first page
+    size_t returned; // Rows handed out so far (counts against the query limit)
+};
+
+// A query's results, fetched a page at a time with
+// MovieDatabase::nextPage. Database-order queries that need a full scan
+// are evaluated lazily: each page only scans as far as it needs to, so
+// paging through a huge catalog touches just the rows actually shown.
+// Other queries are resolved to an ordered ID list when opened.
+class MovieCursor
+{
+private:
+    friend class MovieDatabase;
+
+    MovieQuery query;
+    bool lazyScan;        // Walk the slots on demand instead of using 'ids'
+    std::vector<int> ids; // Result IDs in order (when not scanning lazily)
+    CursorToken token;
+    bool finished;
+
+public:
+    MovieCursor();
+
+    // True while another page can be fetched
+    bool hasMore() const;
+
+    // Position to resume from with MovieDatabase::openCursor
+    CursorToken getToken() const;
+
+    // Rows handed out so far
+    size_t getReturnedCount() const;
+
+    const MovieQuery &getQuery() const;
+};
+
+#endif // MOVIECURSOR_H
@@ -4,26 +4,83 @@
 #include <string>
 #include <algorithm>
 #include <fstream>
+#include <cstdio>
+#include <cstring>
+#include "MovieFile.h"
+#include "LanguageDictionary.h"
+#include "MovieRenderer.h"
+#include "FuzzyMatcher.h"
+
+// Initialize empty database; storage grows as movies are added
+MovieDatabase::MovieDatabase()
+    : statsPaused(false), removalMode(REMOVE_PRESERVE_ORDER), checkpointInterval(1000), journalPaused(false),
+      generation(0), nextId(1), storageMode(STORAGE_OWNED), deadTextBytes(0)
+{
+}
 
-// Initialize empty database with dynamic memory allocation
-MovieDatabase::MovieDatabase() : movieCount(0)
+// Add a movie if its ID is not already taken
+bool MovieDatabase::addMovie(const Movie &movie)
 {
-    movies = new Movie[MAX_MOVIES]; // Allocate memory on heap for 100,000 movies
+    if (idIndex.find(movie.getId()) != idIndex.end())
+    {
+        return false;
+    }
+    return insertMovie(storageMode == STORAGE_POOLED ? Movie(movie, textPool) : Movie(movie));
 }
 
-// Destructor to free allocated memory
-MovieDatabase::~MovieDatabase()
+// Add a movie built by the caller, keeping its name block when it can
+bool MovieDatabase::addMovie(Movie &&movie)
 {
-    delete[] movies; // Free the dynamically allocated memory
+    if (idIndex.find(movie.getId()) != idIndex.end())
+    {
+        return false;
+    }
+    if (storageMode == STORAGE_POOLED)
+    {
+        movie.storeTextIn(textPool);
+    }
+    else if (movie.isPooled())
+    {
+        movie = Movie(movie); // Never keep a pointer into someone else's pool
+    }
+    return insertMovie(std::move(movie));
 }
 
-// Try to add a movie if there's space
-bool MovieDatabase::addMovie(const Movie &movie)
+// Construct a movie directly where the storage mode keeps names
+bool MovieDatabase::emplaceMovie(TextView name, int id, int year, TextView language, double rating)
+{
+    Movie movie = storageMode == STORAGE_POOLED
+                      ? Movie(textPool, name, id, year, LanguageDictionary::intern(language), rating)
+                      : Movie(name, id, year, language, rating);
+    if (insertMovie(std::move(movie)))
+    {
+        return true;
+    }
+    retireText(movie); // Duplicate ID: insertMovie left the movie untouched
+    return false;
+}
+
+// Take over a movie whose text is already where the storage mode wants it
+bool MovieDatabase::insertMovie(Movie &&added)
 {
-    if (movieCount < MAX_MOVIES)
+    if (idIndex.find(added.getId()) == idIndex.end())
     {
-        movies[movieCount] = movie;
-        movieCount++;
+        generation++;
+        idIndex[added.getId()] = static_cast<int>(movies.size());
+        movies.push_back(std::move(added));
+        const Movie &movie = movies.back();
+        columns.append(movie);
+        titleIndex.add(movie.getId(), movie.getNameView());
+        orderIndex.add(movie);
+        if (!statsPaused)
+        {
+            stats.add(movie);
+        }
+        if (movie.getId() >= nextId)
+        {
+            nextId = movie.getId() + 1;
+        }
+        logEdit(MovieJournal::OP_ADD, movie);
         return true;
     }
     return false;
@@ -32,55 +89,433 @@ bool MovieDatabase::addMovie(const Movie &movie)
 // Remove a movie by its ID
 bool MovieDatabase::removeMovie(int id)
 {
-    // Find the movie with the given ID
-    for (int i = 0; i < movieCount; i++)
+    // Look up the slot of the movie with the given ID
+    std::unordered_map<int, int>::iterator it = idIndex.find(id);
+    if (it == idIndex.end())
+    {
+        return false; // Movie not found
+    }
+
+    int i = it->second;
+    idIndex.erase(it);
+    generation++;
+    logEdit(MovieJournal::OP_REMOVE, movies[i]);
+    titleIndex.remove(id, movies[i].getNameView());
+    retireText(movies[i]);
+    orderIndex.remove(movies[i]);
+    stats.remove(movies[i]);
+
+    if (removalMode == REMOVE_SWAP_LAST)
     {
-        if (movies[i].getId() == id)
+        // Move the last movie into the hole and drop the tail slot
+        int last = static_cast<int>(movies.size()) - 1;
+        if (i != last)
         {
-            // Shift all movies after this one to the left
-            for (int j = i; j < movieCount - 1; j++)
-            {
-                movies[j] = movies[j + 1];
-            }
-            movieCount--;
-            return true;
+            std::swap(movies[i], movies[last]);
+            idIndex[movies[i].getId()] = i;
+        }
+        movies.pop_back();
+        columns.swapRemove(i);
+        compactText();
+        return true;
+    }
+
+    // Shift all movies after this one to the left
+    movies.erase(movies.begin() + i);
+    columns.erase(i);
+
+    // The shifted movies moved down one slot
+    reindexFrom(i);
+    compactText();
+    return true;
+}
+
+// Record an edit in the write-ahead log
+void MovieDatabase::logEdit(MovieJournal::Operation operation, const Movie &movie)
+{
+    if (journalPaused || !journal.isOpen())
+    {
+        return;
+    }
+
+    // Reuse the entry's strings: assign only reallocates for a longer name
+    MovieJournal::Entry &entry = journalEntry;
+    entry.operation = operation;
+    entry.id = movie.getId();
+    entry.year = movie.getYear();
+    entry.rating = movie.getRating();
+    if (operation != MovieJournal::OP_REMOVE)
+    {
+        TextView name = movie.getNameView();
+        entry.name.assign(name.data(), name.size());
+        entry.language = movie.getLanguage();
+    }
+    journal.append(entry);
+}
+
+// Count the pool bytes of a movie whose text is going away
+void MovieDatabase::retireText(const Movie &movie)
+{
+    if (movie.isPooled())
+    {
+        deadTextBytes += movie.getTextBytes();
+    }
+}
+
+// Copy the live names into a fresh pool once dead ones dominate
+void MovieDatabase::compactText()
+{
+    if (deadTextBytes < StringPool::BLOCK_BYTES || deadTextBytes < textPool.getUsedBytes() / 2)
+    {
+        return;
+    }
+    StringPool packed;
+    for (size_t i = 0; i < movies.size(); i++)
+    {
+        if (movies[i].isPooled())
+        {
+            movies[i].storeTextIn(packed);
+        }
+    }
+    textPool.swap(packed);
+    deadTextBytes = 0;
+}
+
+// Move every name to where the new mode keeps them
+void MovieDatabase::setStorageMode(StorageMode mode)
+{
+    if (mode == storageMode)
+    {
+        return;
+    }
+    storageMode = mode;
+    for (size_t i = 0; i < movies.size(); i++)
+    {
+        if (mode == STORAGE_POOLED)
+        {
+            movies[i].storeTextIn(textPool);
+        }
+        else
+        {
+            movies[i] = Movie(movies[i]); // Copies own their text
         }
     }
-    return false; // Movie not found
+    if (mode == STORAGE_OWNED)
+    {
+        textPool.clear();
+        deadTextBytes = 0;
+    }
+}
+
+MovieDatabase::StorageMode MovieDatabase::getStorageMode() const
+{
+    return storageMode;
+}
+
+// Set the delete strategy used by removeMovie
+void MovieDatabase::setRemovalMode(RemovalMode mode)
+{
+    removalMode = mode;
+}
+
+// Get the delete strategy used by removeMovie
+MovieDatabase::RemovalMode MovieDatabase::getRemovalMode() const
+{
+    return removalMode;
 }
 
 // Update movie information
 bool MovieDatabase::updateMovie(int id, const std::string &name, int year, const std::string &language, double rating)
 {
-    Movie *movie = findMovieById(id);
-    if (movie != nullptr)
+    std::unordered_map<int, int>::const_iterator it = idIndex.find(id);
+    if (it != idIndex.end())
     {
-        movie->setName(name);
-        movie->setYear(year);
-        movie->setLanguage(language);
-        movie->setRating(rating);
+        Movie &movie = movies[it->second];
+        generation++;
+        orderIndex.remove(movie);
+        stats.remove(movie);
+        if (movie.getNameView() != TextView(name))
+        {
+            titleIndex.remove(id, movie.getNameView());
+            titleIndex.add(id, name);
+            retireText(movie);
+            movie.setName(name, storageMode == STORAGE_POOLED ? &textPool : nullptr);
+        }
+        movie.setYear(year);
+        movie.setLanguage(language);
+        movie.setRating(rating);
+        orderIndex.add(movie);
+        stats.add(movie);
+        columns.assign(it->second, movie);
+        logEdit(MovieJournal::OP_UPDATE, movie);
+        compactText();
         return true;
     }
     return false;
 }
 
-// Find a movie by ID and return pointer to it
-Movie *MovieDatabase::findMovieById(int id)
+// Net effect of a batch on one movie ID
+struct BatchEntry
+{
+    int slot;         // Slot the ID had before the batch, -1 if none
+    bool live;        // Exists after the edits seen so far
+    bool baseRemoved; // The movie in 'slot' was removed at some point
+    bool added;       // Live as a movie added by the batch (appended at the end)
+    bool modified;    // The movie in 'slot' is kept but was updated
+    size_t addOrder;  // Edit that added it, for append order
+    Movie movie;      // Current contents
+};
+
+// Validate everything against a per-ID overlay first, then apply the net
+// effect: in-place updates, one compaction sweep for deletes, appends for
+// adds, and a single round of index maintenance
+bool MovieDatabase::applyBatch(const std::vector<MovieEdit> &edits, BatchResult &result)
 {
-    for (int i = 0; i < movieCount; i++)
+    result.applied = false;
+    result.failedEdit = 0;
+    result.ids.assign(edits.size(), 0);
+
+    std::unordered_map<int, size_t> touched; // ID -> entry
+    std::vector<BatchEntry> entries;
+    touched.reserve(edits.size());
+    int allocator = nextId;
+
+    for (size_t i = 0; i < edits.size(); i++)
+    {
+        const MovieEdit &edit = edits[i];
+        int id = edit.id;
+        if (edit.type == MovieEdit::EDIT_ADD && id <= 0)
+        {
+            id = allocator;
+        }
+        result.ids[i] = id;
+
+        std::unordered_map<int, size_t>::iterator found = touched.find(id);
+        if (found == touched.end())
+        {
+            BatchEntry entry;
+            std::unordered_map<int, int>::const_iterator slot = idIndex.find(id);
+            entry.slot = slot == idIndex.end() ? -1 : slot->second;
+            entry.live = entry.slot >= 0;
+            entry.baseRemoved = false;
+            entry.added = false;
+            entry.modified = false;
+            entry.addOrder = 0;
+            if (entry.live)
+            {
+                entry.movie = movies[entry.slot];
+            }
+            found = touched.insert(std::make_pair(id, entries.size())).first;
+            entries.push_back(entry);
+        }
+        BatchEntry &entry = entries[found->second];
+
+        if ((edit.type == MovieEdit::EDIT_ADD) == entry.live)
+        {
+            result.failedEdit = i; // Add of a taken ID, or edit of a missing one
+            return false;
+        }
+        switch (edit.type)
+        {
+        case MovieEdit::EDIT_ADD:
+            entry.movie = Movie(edit.name, id, edit.year, edit.language, edit.rating);
+            entry.live = true;
+            entry.added = true;
+            entry.addOrder = i;
+            if (id >= allocator)
+            {
+                allocator = id + 1;
+            }
+            break;
+        case MovieEdit::EDIT_UPDATE:
+            entry.movie.setName(edit.name);
+            entry.movie.setYear(edit.year);
+            entry.movie.setLanguage(edit.language);
+            entry.movie.setRating(edit.rating);
+            entry.modified = !entry.added;
+            break;
+        case MovieEdit::EDIT_REMOVE:
+            entry.live = false;
+            if (entry.added)
+            {
+                entry.added = false; // Added and removed within the batch
+            }
+            else
+            {
+                entry.baseRemoved = true;
+                entry.modified = false;
+            }
+            break;
+        }
+    }
+
+    // Take the old versions of removed and updated movies out of the indexes
+    std::vector<std::pair<int, TextView> > titleRemovals, titleAdditions;
+    std::vector<size_t> appended;
+    std::vector<char> dead;
+    int firstDead = static_cast<int>(movies.size());
+    for (size_t e = 0; e < entries.size(); e++)
+    {
+        const BatchEntry &entry = entries[e];
+        if (entry.slot >= 0 && (entry.baseRemoved || entry.modified))
+        {
+            const Movie &old = movies[entry.slot];
+            if (entry.baseRemoved || old.getNameView() != entry.movie.getNameView())
+            {
+                titleRemovals.push_back(std::make_pair(old.getId(), old.getFoldedName()));
+            }
+            orderIndex.remove(old);
+            stats.remove(old);
+        }
+        if (entry.baseRemoved)
+        {
+            logEdit(MovieJournal::OP_REMOVE, movies[entry.slot]);
+            retireText(movies[entry.slot]);
+            if (dead.empty())
+            {
+                dead.resize(movies.size(), 0);
+            }
+            dead[entry.slot] = 1;
+            firstDead = std::min(firstDead, entry.slot);
+        }
+        if (entry.added)
+        {
+            appended.push_back(e);
+        }
+    }
+    // Names are unindexed before the movies holding them change
+    titleIndex.update(titleRemovals, titleAdditions);
+    titleRemovals.clear();
+
+    // Updates in place
+    std::vector<int> renamed;
+    for (size_t e = 0; e < entries.size(); e++)
+    {
+        const BatchEntry &entry = entries[e];
+        if (entry.modified)
+        {
+            if (movies[entry.slot].getNameView() != entry.movie.getNameView())
+            {
+                renamed.push_back(entry.movie.getId());
+            }
+            retireText(movies[entry.slot]);
+            movies[entry.slot] = storageMode == STORAGE_POOLED ? Movie(entry.movie, textPool) : entry.movie;
+            orderIndex.add(entry.movie);
+            stats.add(entry.movie);
+            logEdit(MovieJournal::OP_UPDATE, entry.movie);
+        }
+    }
+
+    // One sweep closes every gap, keeping the survivors in order
+    bool compacted = !dead.empty();
+    if (compacted)
+    {
+        size_t kept = firstDead;
+        for (size_t i = firstDead; i < movies.size(); i++)
+        {
+            if (!dead[i])
+            {
+                if (kept != i)
+                {
+                    movies[kept] = std::move(movies[i]);
+                }
+                kept++;
+            }
+        }
+        movies.resize(kept);
+        for (size_t e = 0; e < entries.size(); e++)
+        {
+            if (entries[e].baseRemoved)
+            {
+                idIndex.erase(entries[e].movie.getId());
+            }
+        }
+    }
+
+    // Adds go to the end in the order they were made
+    std::sort(appended.begin(), appended.end(),
+              [&](size_t a, size_t b) { return entries[a].addOrder < entries[b].addOrder; });
+    size_t firstAppended = movies.size();
+    for (size_t k = 0; k < appended.size(); k++)
+    {
+        Movie &added = entries[appended[k]].movie;
+        movies.push_back(storageMode == STORAGE_POOLED ? Movie(added, textPool) : std::move(added));
+        const Movie &movie = movies.back();
+        orderIndex.add(movie);
+        stats.add(movie);
+        logEdit(MovieJournal::OP_ADD, movie);
+    }
+
+    // Slot-addressed structures: rebuild after a compaction, else patch
+    if (compacted)
     {
-        if (movies[i].getId() == id)
+        reindexFrom(firstDead);
+        columns.clear();
+        columns.reserve(movies.size());
+        for (size_t i = 0; i < movies.size(); i++)
         {
-            return &movies[i];
+            columns.append(movies[i]);
         }
     }
+    else
+    {
+        reindexFrom(static_cast<int>(firstAppended));
+        for (size_t e = 0; e < entries.size(); e++)
+        {
+            if (entries[e].modified)
+            {
+                columns.assign(entries[e].slot, movies[entries[e].slot]);
+            }
+        }
+        for (size_t i = firstAppended; i < movies.size(); i++)
+        {
+            columns.append(movies[i]);
+        }
+    }
+
+    // New names go in once the array has stopped moving
+    for (size_t k = 0; k < renamed.size(); k++)
+    {
+        const Movie &movie = movies[idIndex[renamed[k]]];
+        titleAdditions.push_back(std::make_pair(movie.getId(), movie.getFoldedName()));
+    }
+    for (size_t i = firstAppended; i < movies.size(); i++)
+    {
+        titleAdditions.push_back(std::make_pair(movies[i].getId(), movies[i].getFoldedName()));
+    }
+    titleIndex.update(titleRemovals, titleAdditions);
+
+    nextId = allocator;
+    compactText();
+    generation++;
+    result.applied = true;
+    return true;
+}
+
+// Find a movie by ID and return pointer to it
+const Movie *MovieDatabase::findMovieById(int id) const
+{
+    std::unordered_map<int, int>::const_iterator it = idIndex.find(id);
+    if (it != idIndex.end())
+    {
+        return &movies[it->second];
+    }
     return nullptr; // Not found
 }
 
+// Point the index at the current slot of every movie from 'first' onwards
+void MovieDatabase::reindexFrom(int first)
+{
+    for (int i = first; i < static_cast<int>(movies.size()); i++)
+    {
+        idIndex[movies[i].getId()] = i;
+    }
+}
+
 // Display all movies with a nice table format
 void MovieDatabase::displayAllMovies() const
 {
-    if (movieCount == 0)
+    if (movies.empty())
     {
         std::cout << "\nThe database is empty!" << std::endl;
         return;
@@ -97,37 +532,33 @@ void MovieDatabase::displayAllMovies() const
               << "Rating" << std::endl;
     std::cout << std::string(100, '-') << std::endl;
 
-    for (int i = 0; i < movieCount; i++)
+    MovieRenderer renderer;
+    for (size_t i = 0; i < movies.size(); i++)
     {
-        movies[i].displayInfo();
+        renderer.addRow(movies[i]);
     }
+    renderer.flush();
     std::cout << std::string(100, '-') << std::endl;
-    std::cout << "Total movies: " << movieCount << " | Capacity: " << MAX_MOVIES << " | Available: " << (MAX_MOVIES - movieCount) << std::endl;
+    std::cout << "Total movies: " << movies.size() << std::endl;
     std::cout << std::string(100, '=') << std::endl;
 }
 
 // Find the highest rating and display all movies with that rating
 void MovieDatabase::displayTopRatedMovies() const
 {
-    if (movieCount == 0)
+    if (movies.empty())
     {
         std::cout << "\nThe database is empty!" << std::endl;
         return;
     }
 
-    // First loop: find the maximum rating
-    int maxRating = 0;
-    for (int i = 0; i < movieCount; i++)
-    {
-        if (movies[i].getRating() > maxRating)
-        {
-            maxRating = movies[i].getRating();
-        }
-    }
+    // The best rating is kept up to date by the catalog statistics
+    double maxRating = stats.getMaxRating();
 
     std::cout << "\n"
               << std::string(100, '=') << std::endl;
-    std::cout << "                           TOP-RATED MOVIE(S) [Rating: " << maxRating << "/5]" << std::endl;
+    std::cout << "                           TOP-RATED MOVIE(S) [Rating: " << std::fixed << std::setprecision(1)
+              << maxRating << "/10]" << std::endl;
     std::cout << std::string(100, '=') << std::endl;
     std::cout << std::left << std::setw(5) << "ID"
               << std::setw(50) << "Movie Name"
@@ -136,16 +567,17 @@ void MovieDatabase::displayTopRatedMovies() const
               << "Rating" << std::endl;
     std::cout << std::string(100, '-') << std::endl;
 
-    // Second loop: display all movies that have the max rating
+    // Display all movies that share it, straight from the index
+    std::vector<const Movie *> matches;
+    findMoviesByRating(maxRating, maxRating, matches);
     int count = 0;
-    for (int i = 0; i < movieCount; i++)
+    MovieRenderer renderer;
+    for (size_t i = 0; i < matches.size(); i++)
     {
-        if (movies[i].getRating() == maxRating)
-        {
-            movies[i].displayInfo();
-            count++;
-        }
+        renderer.addRow(*matches[i]);
+        count++;
     }
+    renderer.flush();
 
     std::cout << std::string(100, '-') << std::endl;
     std::cout << "Total top-rated movies: " << count << std::endl;
@@ -157,73 +589,34 @@ void MovieDatabase::displayAvailableLanguages() const
 {
     std::cout << "\nAvailable languages in database:" << std::endl;
 
-    if (movieCount == 0)
+    if (movies.empty())
     {
         std::cout << "  No movies in database." << std::endl;
         return;
     }
 
-    // Use a simple array to store unique languages and their counts
-    // This avoids using std::map or std::unordered_map for C++11 compatibility
-    const int MAX_LANGUAGES = 50;
-    std::string languages[MAX_LANGUAGES];
-    int counts[MAX_LANGUAGES];
-    int uniqueLanguageCount = 0;
-
-    // Collect all unique languages and count them
-    for (int i = 0; i < movieCount; i++)
+    // Languages present in this database, from the maintained counts
+    std::vector<int> languageIds;
+    for (int id = 0; id < stats.getLanguageLimit(); id++)
     {
-        std::string lang = movies[i].getLanguage();
-        
-        // Convert to lowercase for consistent comparison
-        std::transform(lang.begin(), lang.end(), lang.begin(), ::tolower);
-
-        // Check if this language already exists in our list
-        bool found = false;
-        for (int j = 0; j < uniqueLanguageCount; j++)
-        {
-            if (languages[j] == lang)
-            {
-                counts[j]++;
-                found = true;
-                break;
-            }
-        }
-
-        // If not found, add it as a new language
-        if (!found && uniqueLanguageCount < MAX_LANGUAGES)
+        if (stats.getLanguageCount(id) > 0)
         {
-            languages[uniqueLanguageCount] = lang;
-            counts[uniqueLanguageCount] = 1;
-            uniqueLanguageCount++;
+            languageIds.push_back(id);
         }
     }
+    int uniqueLanguageCount = static_cast<int>(languageIds.size());
 
-    // Sort languages alphabetically (simple bubble sort)
-    for (int i = 0; i < uniqueLanguageCount - 1; i++)
-    {
-        for (int j = 0; j < uniqueLanguageCount - i - 1; j++)
-        {
-            if (languages[j] > languages[j + 1])
-            {
-                // Swap languages
-                std::string tempLang = languages[j];
-                languages[j] = languages[j + 1];
-                languages[j + 1] = tempLang;
-
-                // Swap counts
-                int tempCount = counts[j];
-                counts[j] = counts[j + 1];
-                counts[j + 1] = tempCount;
-            }
-        }
-    }
+    // Sort languages alphabetically
+    std::sort(languageIds.begin(), languageIds.end(), [](int a, int b) {
+        return LanguageDictionary::getFoldedName(a) < LanguageDictionary::getFoldedName(b);
+    });
 
     // Display all unique languages with their counts
     for (int i = 0; i < uniqueLanguageCount; i++)
     {
         // Capitalize first letter for display
-        std::string displayLang = languages[i];
+        std::string displayLang = LanguageDictionary::getFoldedName(languageIds[i]);
+        int languageCount = stats.getLanguageCount(languageIds[i]);
         if (!displayLang.empty())
         {
             displayLang[0] = toupper(displayLang[0]);
@@ -231,12 +624,12 @@ void MovieDatabase::displayAvailableLanguages() const
         
         std::cout << "  " << std::setw(2) << (i + 1) << ". " 
                   << std::left << std::setw(15) << displayLang 
-                  << " - " << std::setw(3) << counts[i] 
-                  << " movie" << (counts[i] != 1 ? "s" : "") << std::endl;
+                  << " - " << std::setw(3) << languageCount 
+                  << " movie" << (languageCount != 1 ? "s" : "") << std::endl;
     }
 
-    std::cout << "\n  Total: " << movieCount << " movie" 
-              << (movieCount != 1 ? "s" : "") 
+    std::cout << "\n  Total: " << movies.size() << " movie" 
+              << (movies.size() != 1 ? "s" : "") 
               << " across " << uniqueLanguageCount << " language" 
               << (uniqueLanguageCount != 1 ? "s" : "") << std::endl;
 }
@@ -255,15 +648,20 @@ void MovieDatabase::displayMoviesByLanguage(const std::string &language) const
               << "Rating" << std::endl;
     std::cout << std::string(100, '-') << std::endl;
 
+    // Resolve the language once; each movie already carries its language ID
+    std::vector<const Movie *> matches;
+    if (LanguageDictionary::find(language) >= 0)
+    {
+        runQuery(MovieQuery().language(language), matches);
+    }
     int count = 0;
-    for (int i = 0; i < movieCount; i++)
+    MovieRenderer renderer;
+    for (size_t i = 0; i < matches.size(); i++)
     {
-        if (movies[i].isLanguage(language))
-        {
-            movies[i].displayInfo();
-            count++;
-        }
+        renderer.addRow(*matches[i]);
+        count++;
     }
+    renderer.flush();
 
     if (count == 0)
     {
@@ -277,24 +675,23 @@ void MovieDatabase::displayMoviesByLanguage(const std::string &language) const
     std::cout << std::string(100, '=') << std::endl;
 }
 
+// Count movies in a language without scanning
+int MovieDatabase::getLanguageCount(const std::string &language) const
+{
+    return stats.getLanguageCount(LanguageDictionary::find(language));
+}
+
 // Find and display the latest movies by year
 void MovieDatabase::displayLatestMovies() const
 {
-    if (movieCount == 0)
+    if (movies.empty())
     {
         std::cout << "\nThe database is empty!" << std::endl;
         return;
     }
 
-    // Find the most recent year
-    int latestYear = 0;
-    for (int i = 0; i < movieCount; i++)
-    {
-        if (movies[i].getYear() > latestYear)
-        {
-            latestYear = movies[i].getYear();
-        }
-    }
+    // The most recent year is kept up to date by the catalog statistics
+    int latestYear = stats.getMaxYear();
 
     std::cout << "\n"
               << std::string(100, '=') << std::endl;
@@ -308,15 +705,16 @@ void MovieDatabase::displayLatestMovies() const
     std::cout << std::string(100, '-') << std::endl;
 
     // Display all movies from that year
+    std::vector<const Movie *> matches;
+    findMoviesByYear(latestYear, latestYear, matches);
     int count = 0;
-    for (int i = 0; i < movieCount; i++)
+    MovieRenderer renderer;
+    for (size_t i = 0; i < matches.size(); i++)
     {
-        if (movies[i].getYear() == latestYear)
-        {
-            movies[i].displayInfo();
-            count++;
-        }
+        renderer.addRow(*matches[i]);
+        count++;
     }
+    renderer.flush();
 
     std::cout << std::string(100, '-') << std::endl;
     std::cout << "Total latest movies: " << count << std::endl;
@@ -337,24 +735,34 @@ void MovieDatabase::searchMovieByName(const std::string &searchTerm) const
               << "Rating" << std::endl;
     std::cout << std::string(100, '-') << std::endl;
 
-    int count = 0;
-    std::string lowerSearchTerm = searchTerm;
-    std::transform(lowerSearchTerm.begin(), lowerSearchTerm.end(), lowerSearchTerm.begin(), ::tolower);
+    std::vector<const Movie *> matches;
+    findMoviesByName(searchTerm, matches);
 
-    for (int i = 0; i < movieCount; i++)
+    int count = 0;
+    MovieRenderer renderer;
+    for (size_t i = 0; i < matches.size(); i++)
     {
-        std::string movieName = movies[i].getName();
-        std::transform(movieName.begin(), movieName.end(), movieName.begin(), ::tolower);
+        renderer.addRow(*matches[i]);
+        count++;
+    }
+    renderer.flush();
 
-        // Check if movie name contains the search term
-        if (movieName.find(lowerSearchTerm) != std::string::npos)
+    // Nothing contains the term: list the closest titles instead
+    std::vector<TitleMatch> similar;
+    if (count == 0)
+    {
+        findSimilarNames(searchTerm, 10, similar);
+    }
+    if (!similar.empty())
+    {
+        std::cout << "No exact match for \"" << searchTerm << "\". Did you mean:" << std::endl;
+        for (size_t i = 0; i < similar.size(); i++)
         {
-            movies[i].displayInfo();
-            count++;
+            renderer.addRow(*similar[i].movie);
         }
+        renderer.flush();
     }
-
-    if (count == 0)
+    else if (count == 0)
     {
         std::cout << "No movies found matching \"" << searchTerm << "\"" << std::endl;
         std::cout << "\nSearch Tips:" << std::endl;
@@ -369,157 +777,1158 @@ void MovieDatabase::searchMovieByName(const std::string &searchTerm) const
     std::cout << std::string(100, '=') << std::endl;
 }
 
-// Return how many movies are in the database
-int MovieDatabase::getMovieCount() const
+// Concatenate per-chunk results in chunk order
+static void joinChunks(const std::vector<std::vector<int> > &partial, std::vector<int> &joined)
 {
-    return movieCount;
+    size_t total = 0;
+    for (size_t i = 0; i < partial.size(); i++)
+    {
+        total += partial[i].size();
+    }
+    joined.reserve(joined.size() + total);
+    for (size_t i = 0; i < partial.size(); i++)
+    {
+        joined.insert(joined.end(), partial[i].begin(), partial[i].end());
+    }
 }
 
-// Get the next available ID
-int MovieDatabase::getNextId() const
+// Test for 'term' inside (or, with prefixOnly, at the start of) a lowercase name
+static bool matchesFolded(TextView foldedName, const std::string &term, bool prefixOnly)
 {
-    int maxId = 0;
-    for (int i = 0; i < movieCount; i++)
+    if (term.size() > foldedName.size())
     {
-        if (movies[i].getId() > maxId)
-        {
-            maxId = movies[i].getId();
-        }
+        return false;
+    }
+    if (prefixOnly)
+    {
+        return std::memcmp(foldedName.data(), term.data(), term.size()) == 0;
     }
-    return maxId + 1;
+    return std::search(foldedName.data(), foldedName.data() + foldedName.size(), term.begin(), term.end()) !=
+           foldedName.data() + foldedName.size();
 }
 
-// Check if database is full
-bool MovieDatabase::isFull() const
+// Find movies by name, using the trigram index to narrow the candidates
+void MovieDatabase::findMoviesByName(const std::string &term, std::vector<const Movie *> &results,
+                                     bool prefixOnly) const
 {
-    return movieCount >= MAX_MOVIES;
-}
+    std::string lowerTerm = Movie::foldCase(term);
+    std::string key = (prefixOnly ? "P" : "F") + lowerTerm;
 
-// Get maximum capacity
-int MovieDatabase::getMaxCapacity() const
-{
-    return MAX_MOVIES;
+    std::vector<int> slots;
+    if (!queryCache.find(key, generation, slots, nullptr))
+    {
+        findNameSlots(lowerTerm, prefixOnly, slots);
+        queryCache.store(key, generation, slots, QueryPlan());
+    }
+    resolveSlots(slots, results);
 }
 
-// Load movies from text file into the database
-void MovieDatabase::initializeSampleData()
+// Slots of the movies matching a lowercase name term, in database order
+void MovieDatabase::findNameSlots(const std::string &lowerTerm, bool prefixOnly, std::vector<int> &slots) const
 {
-    std::ifstream file("movies.txt");
+    slots.clear();
 
-    if (!file.is_open())
+    std::vector<int> candidates;
+    if (titleIndex.findCandidates(lowerTerm, candidates))
     {
-        std::cerr << "Error: Could not open movies.txt file!" << std::endl;
-        std::cerr << "Please ensure movies.txt exists in the program directory." << std::endl;
+        // Check each candidate, then restore database order via the slots
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            int slot = idIndex.find(candidates[i])->second;
+            if (matchesFolded(movies[slot].getFoldedName(), lowerTerm, prefixOnly))
+            {
+                slots.push_back(slot);
+            }
+        }
+        std::sort(slots.begin(), slots.end());
         return;
     }
 
-    std::string line;
-    int loadedCount = 0;
-
-    while (std::getline(file, line))
-    {
-        // Skip empty lines
-        if (line.empty())
+    // Terms shorter than a trigram: scan the packed name arena in chunks
+    std::vector<std::vector<int> > partial(ScanExecutor::chunkCount(columns.size()));
+    executor.run(partial.size(), [&](size_t chunk) {
+        size_t begin, end;
+        ScanExecutor::chunkBounds(columns.size(), chunk, begin, end);
+        for (size_t i = begin; i < end; i++)
         {
-            continue;
+            const char *name = columns.getNameData(static_cast<int>(i));
+            const char *nameEnd = name + columns.getNameLength(static_cast<int>(i));
+            bool match = prefixOnly
+                             ? (nameEnd - name >= static_cast<std::ptrdiff_t>(lowerTerm.size()) &&
+                                std::equal(lowerTerm.begin(), lowerTerm.end(), name))
+                             : std::search(name, nameEnd, lowerTerm.begin(), lowerTerm.end()) != nameEnd;
+            if (match)
+            {
+                partial[chunk].push_back(static_cast<int>(i));
+            }
         }
+    });
 
-        // Parse the line: Name|ID|Year|Language|Rating
-        std::string name, language;
-        int id, year;
-        double rating;
+    joinChunks(partial, slots);
+}
 
-        // Find delimiter positions
-        size_t pos1 = line.find('|');
-        size_t pos2 = line.find('|', pos1 + 1);
-        size_t pos3 = line.find('|', pos2 + 1);
-        size_t pos4 = line.find('|', pos3 + 1);
+// Widen the edit budget one step at a time. Pass k takes the index's
+// candidates for k edits, which hold every movie within k edits, so once
+// a pass has run every movie at most k - 1 edits away has been recorded
+// and pass k only has to add the lowest-ID movies exactly k edits away:
+// candidates arrive by ascending ID, so it stops as soon as the results
+// are full. Any candidate found closer than k is recorded too. Terms too
+// short to split into k + 1 trigram pieces cannot be filtered at all,
+// so the packed lowercase names are scanned once for the whole budget.
+void MovieDatabase::findSimilarNames(const std::string &term, size_t limit, std::vector<TitleMatch> &results,
+                                     int maxDistance) const
+{
+    results.clear();
+    std::string lowerTerm = Movie::foldCase(term);
+    if (limit == 0 || lowerTerm.empty())
+    {
+        return;
+    }
 
-        if (pos1 == std::string::npos || pos2 == std::string::npos ||
-            pos3 == std::string::npos || pos4 == std::string::npos)
+    if (lowerTerm.size() < TitleIndex::MIN_QUERY_LENGTH)
+    {
+        // Too short for trigrams (or to tolerate a typo): the first exact
+        // matches in database order
+        for (size_t slot = 0; slot < columns.size() && results.size() < limit; slot++)
         {
-            std::cerr << "Warning: Skipping malformed line: " << line << std::endl;
-            continue;
+            const char *name = columns.getNameData(static_cast<int>(slot));
+            const char *nameEnd = name + columns.getNameLength(static_cast<int>(slot));
+            if (std::search(name, nameEnd, lowerTerm.begin(), lowerTerm.end()) != nameEnd)
+            {
+                TitleMatch match = {&movies[slot], 0};
+                results.push_back(match);
+            }
         }
+        return;
+    }
 
-        try
+    struct Measured
+    {
+        int id;
+        int distance;
+        bool recorded; // Already in found
+    };
+    std::vector<std::pair<int, int> > found; // (distance, ID)
+    std::vector<Measured> measured, next;    // Every candidate seen so far, by ID
+    std::vector<int> candidates;
+    int budget = maxDistance < 0 ? FuzzyMatcher::defaultLimit(lowerTerm.size()) : maxDistance;
+    FuzzyMatcher matcher(lowerTerm);
+    for (int k = 0; k <= budget && found.size() < limit; k++)
+    {
+        if (!titleIndex.findApproximate(lowerTerm, k, candidates))
         {
-            // Extract fields
-            name = line.substr(0, pos1);
-            id = std::stoi(line.substr(pos1 + 1, pos2 - pos1 - 1));
-            year = std::stoi(line.substr(pos2 + 1, pos3 - pos2 - 1));
-            language = line.substr(pos3 + 1, pos4 - pos3 - 1);
-            rating = std::stod(line.substr(pos4 + 1));
+            // No filter possible: measure every name against the full budget
+            std::vector<std::vector<std::pair<int, int> > > partial(ScanExecutor::chunkCount(columns.size()));
+            executor.run(partial.size(), [&](size_t chunk) {
+                FuzzyMatcher chunkMatcher(lowerTerm);
+                size_t begin, end;
+                ScanExecutor::chunkBounds(columns.size(), chunk, begin, end);
+                for (size_t i = begin; i < end; i++)
+                {
+                    int slot = static_cast<int>(i);
+                    int distance = chunkMatcher.distanceIn(
+                        TextView(columns.getNameData(slot), columns.getNameLength(slot)), budget);
+                    if (distance <= budget)
+                    {
+                        partial[chunk].push_back(std::make_pair(distance, movies[i].getId()));
+                    }
+                }
+            });
+            found.clear();
+            for (size_t chunk = 0; chunk < partial.size(); chunk++)
+            {
+                found.insert(found.end(), partial[chunk].begin(), partial[chunk].end());
+            }
+            break;
+        }
 
-            // Add movie to database
-            if (addMovie(Movie(name, id, year, language, rating)))
+        next.clear();
+        size_t previous = 0;
+        for (size_t i = 0; i < candidates.size() && found.size() < limit; i++)
+        {
+            // Both lists ascend by ID: reuse distances measured in earlier
+            // passes, and record each movie once, in the first pass it fits
+            while (previous < measured.size() && measured[previous].id < candidates[i])
             {
-                loadedCount++;
+                next.push_back(measured[previous++]);
+            }
+            Measured entry = {candidates[i], 0, false};
+            if (previous < measured.size() && measured[previous].id == candidates[i])
+            {
+                entry = measured[previous++];
             }
             else
             {
-                std::cerr << "Warning: Could not add movie (database full): " << name << std::endl;
+                int slot = idIndex.find(candidates[i])->second;
+                entry.distance =
+                    matcher.distanceIn(TextView(columns.getNameData(slot), columns.getNameLength(slot)), budget);
             }
+            if (!entry.recorded && entry.distance <= k)
+            {
+                found.push_back(std::make_pair(entry.distance, entry.id));
+                entry.recorded = true;
+            }
+            next.push_back(entry);
+        }
+        next.insert(next.end(), measured.begin() + previous, measured.end());
+        measured.swap(next);
+    }
+
+    // Closest first; ties by ID
+    std::sort(found.begin(), found.end());
+    if (found.size() > limit)
+    {
+        found.resize(limit);
+    }
+    for (size_t i = 0; i < found.size(); i++)
+    {
+        TitleMatch match = {&movies[idIndex.find(found[i].second)->second], found[i].first};
+        results.push_back(match);
+    }
+}
+
+// Turn slots into movie pointers
+void MovieDatabase::resolveSlots(const std::vector<int> &slots, std::vector<const Movie *> &results) const
+{
+    results.clear();
+    results.reserve(slots.size());
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        results.push_back(&movies[slots[i]]);
+    }
+}
+
+// Map index results (movie IDs) back to the stored movies
+void MovieDatabase::resolveIds(const std::vector<int> &ids, std::vector<const Movie *> &results) const
+{
+    results.clear();
+    results.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        results.push_back(&movies[idIndex.find(ids[i])->second]);
+    }
+}
+
+// The k highest rated movies, best first
+void MovieDatabase::topK(int k, std::vector<const Movie *> &results) const
+{
+    std::vector<int> ids;
+    orderIndex.topRated(k, ids);
+    resolveIds(ids, results);
+}
+
+// The k most recent movies, newest first
+void MovieDatabase::latestK(int k, std::vector<const Movie *> &results) const
+{
+    std::vector<int> ids;
+    orderIndex.latest(k, ids);
+    resolveIds(ids, results);
+}
+
+// Movies rated between minRating and maxRating (inclusive), lowest first
+void MovieDatabase::findMoviesByRating(double minRating, double maxRating,
+                                       std::vector<const Movie *> &results) const
+{
+    std::vector<int> ids;
+    orderIndex.ratingRange(minRating, maxRating, ids);
+    resolveIds(ids, results);
+}
+
+// Movies released between fromYear and toYear (inclusive), earliest first
+void MovieDatabase::findMoviesByYear(int fromYear, int toYear, std::vector<const Movie *> &results) const
+{
+    std::vector<int> ids;
+    orderIndex.yearRange(fromYear, toYear, ids);
+    resolveIds(ids, results);
+}
+
+// An index hit (tree or posting walk plus an ID lookup) costs several
+// times as much as testing one slot in a column scan
+static const size_t INDEX_ROW_COST = 8;
+
+// Choose the cheapest way to produce a query's candidates
+QueryPlan MovieDatabase::planQuery(const MovieQuery &query) const
+{
+    QueryPlan plan;
+    plan.access = QueryPlan::ACCESS_SCAN;
+    plan.estimatedRows = movies.size();
+    size_t bestCost = movies.size();
+
+    QueryPlan empty;
+    empty.access = QueryPlan::ACCESS_EMPTY;
+    empty.estimatedRows = 0;
+
+    // Contradictory ranges and unknown languages can't match anything
+    if ((query.filtersYears() && query.getFromYear() > query.getToYear()) ||
+        (query.filtersRatings() && query.getMinRating() > query.getMaxRating()))
+    {
+        return empty;
+    }
+    if (query.filtersLanguage() && getLanguageCount(query.getLanguage()) == 0)
+    {
+        return empty;
+    }
+
+    size_t estimate = 0;
+    if (query.filtersName() && titleIndex.estimateCandidates(Movie::foldCase(query.getNameTerm()), estimate))
+    {
+        if (estimate == 0)
+        {
+            return empty;
         }
-        catch (const std::exception &e)
+        if (estimate * INDEX_ROW_COST < bestCost)
         {
-            std::cerr << "Warning: Error parsing line: " << line << std::endl;
-            std::cerr << "  Exception: " << e.what() << std::endl;
+            plan.access = QueryPlan::ACCESS_NAME_INDEX;
+            plan.estimatedRows = estimate;
+            bestCost = estimate * INDEX_ROW_COST;
         }
     }
 
-    file.close();
+    // Range counts stop as soon as they can no longer beat the best plan
+    if (query.filtersRatings())
+    {
+        estimate = orderIndex.countRatingRange(query.getMinRating(), query.getMaxRating(),
+                                               bestCost / INDEX_ROW_COST + 1);
+        if (estimate == 0)
+        {
+            return empty;
+        }
+        if (estimate * INDEX_ROW_COST < bestCost)
+        {
+            plan.access = QueryPlan::ACCESS_RATING_INDEX;
+            plan.estimatedRows = estimate;
+            bestCost = estimate * INDEX_ROW_COST;
+        }
+    }
+    if (query.filtersYears())
+    {
+        estimate = orderIndex.countYearRange(query.getFromYear(), query.getToYear(),
+                                             bestCost / INDEX_ROW_COST + 1);
+        if (estimate == 0)
+        {
+            return empty;
+        }
+        if (estimate * INDEX_ROW_COST < bestCost)
+        {
+            plan.access = QueryPlan::ACCESS_YEAR_INDEX;
+            plan.estimatedRows = estimate;
+        }
+    }
+    return plan;
+}
+
+// A query's predicates, tested against one slot of the columns
+class QueryFilter
+{
+private:
+    const MovieQuery &query;
+    const MovieColumns &columns;
+    int languageId;
+    std::string term;
+
+public:
+    QueryFilter(const MovieQuery &query, const MovieColumns &columns)
+        : query(query), columns(columns),
+          languageId(query.filtersLanguage() ? LanguageDictionary::find(query.getLanguage()) : -1),
+          term(Movie::foldCase(query.getNameTerm()))
+    {
+    }
+
+    bool matches(int slot) const
+    {
+        if (query.filtersLanguage() && columns.getLanguageIds()[slot] != languageId)
+        {
+            return false;
+        }
+        int year = columns.getYears()[slot];
+        if (query.filtersYears() && (year < query.getFromYear() || year > query.getToYear()))
+        {
+            return false;
+        }
+        double rating = columns.getRatings()[slot];
+        if (query.filtersRatings() && (rating < query.getMinRating() || rating > query.getMaxRating()))
+        {
+            return false;
+        }
+        if (query.filtersName())
+        {
+            const char *name = columns.getNameData(slot);
+            const char *nameEnd = name + columns.getNameLength(slot);
+            return std::search(name, nameEnd, term.begin(), term.end()) != nameEnd;
+        }
+        return true;
+    }
+};
+
+// Comparator over slots for MovieQuery's orderings (ties: ascending ID)
+struct QuerySlotOrder
+{
+    MovieQuery::Order order;
+    const std::vector<Movie> &movies;
+    const std::vector<int> &ids;
+    const std::vector<int> &years;
+    const std::vector<double> &ratings;
+
+    QuerySlotOrder(MovieQuery::Order order, const std::vector<Movie> &movies, const MovieColumns &columns)
+        : order(order), movies(movies), ids(columns.getIds()), years(columns.getYears()),
+          ratings(columns.getRatings())
+    {
+    }
+
+    bool operator()(int a, int b) const
+    {
+        switch (order)
+        {
+        case MovieQuery::ORDER_RATING:
+            if (ratings[a] != ratings[b])
+            {
+                return ratings[a] > ratings[b];
+            }
+            break;
+        case MovieQuery::ORDER_YEAR:
+            if (years[a] != years[b])
+            {
+                return years[a] > years[b];
+            }
+            break;
+        case MovieQuery::ORDER_NAME:
+        {
+            int cmp = movies[a].getFoldedName().compare(movies[b].getFoldedName());
+            if (cmp != 0)
+            {
+                return cmp < 0;
+            }
+            break;
+        }
+        case MovieQuery::ORDER_ID:
+            break;
+        default:
+            return a < b; // Database order
+        }
+        return ids[a] < ids[b];
+    }
+};
+
+// Fetch candidates through the plan's access path, test the remaining
+// predicates on the columns, then sort and cut to the limit
+void MovieDatabase::runQuery(const MovieQuery &query, std::vector<const Movie *> &results,
+                             QueryPlan *plan) const
+{
+    std::string key = "Q" + query.normalizedKey();
+
+    std::vector<int> slots;
+    QueryPlan chosen;
+    if (!queryCache.find(key, generation, slots, &chosen))
+    {
+        chosen = planQuery(query);
+        if (chosen.access != QueryPlan::ACCESS_EMPTY)
+        {
+            runQuerySlots(query, chosen, slots);
+        }
+        queryCache.store(key, generation, slots, chosen);
+    }
+    if (plan != nullptr)
+    {
+        *plan = chosen;
+    }
+    resolveSlots(slots, results);
+}
+
+// Produce a query's result slots in order along the planned access path
+void MovieDatabase::runQuerySlots(const MovieQuery &query, const QueryPlan &chosen, std::vector<int> &slots) const
+{
+    slots.clear();
+    QueryFilter filter(query, columns);
+
+    if (chosen.access == QueryPlan::ACCESS_SCAN)
+    {
+        // Scan the columns chunk by chunk; each chunk keeps its own matches
+        // and they are joined in chunk order, so slots stay ascending
+        const std::vector<double> &ratings = columns.getRatings();
+        const std::vector<int> &years = columns.getYears();
+        std::vector<std::vector<int> > partial(ScanExecutor::chunkCount(movies.size()));
+        executor.run(partial.size(), [&](size_t chunk) {
+            size_t begin, end;
+            ScanExecutor::chunkBounds(movies.size(), chunk, begin, end);
+            std::vector<int> &matches = partial[chunk];
+
+            // Let a vectorized range filter make the first cut when there is one
+            if (query.filtersRatings())
+            {
+                ScanKernels::filterInRange(ratings.data() + begin, end - begin, query.getMinRating(),
+                                           query.getMaxRating(), matches);
+            }
+            else if (query.filtersYears())
+            {
+                ScanKernels::filterInRange(years.data() + begin, end - begin, query.getFromYear(),
+                                           query.getToYear(), matches);
+            }
+            else
+            {
+                matches.resize(end - begin);
+                for (size_t i = 0; i < matches.size(); i++)
+                {
+                    matches[i] = static_cast<int>(i);
+                }
+            }
+
+            size_t kept = 0;
+            for (size_t i = 0; i < matches.size(); i++)
+            {
+                int slot = matches[i] + static_cast<int>(begin);
+                if (filter.matches(slot))
+                {
+                    matches[kept++] = slot;
+                }
+            }
+            matches.resize(kept);
+        });
+        joinChunks(partial, slots);
+    }
+    else
+    {
+        // Candidate IDs from the chosen index, checked against every predicate
+        std::vector<int> ids;
+        switch (chosen.access)
+        {
+        case QueryPlan::ACCESS_NAME_INDEX:
+            titleIndex.findCandidates(Movie::foldCase(query.getNameTerm()), ids);
+            break;
+        case QueryPlan::ACCESS_RATING_INDEX:
+            orderIndex.ratingRange(query.getMinRating(), query.getMaxRating(), ids);
+            break;
+        default:
+            orderIndex.yearRange(query.getFromYear(), query.getToYear(), ids);
+            break;
+        }
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            int slot = idIndex.find(ids[i])->second;
+            if (filter.matches(slot))
+            {
+                slots.push_back(slot);
+            }
+        }
+    }
 
-    std::cout << "Successfully loaded " << loadedCount << " movies from movies.txt" << std::endl;
+    // Order the survivors; only the first 'limit' need to be fully sorted
+    QuerySlotOrder before(query.getOrder(), movies, columns);
+    size_t limit = query.getLimit() > 0 ? static_cast<size_t>(query.getLimit()) : slots.size();
+    if (query.getOrder() == MovieQuery::ORDER_DATABASE && chosen.access == QueryPlan::ACCESS_SCAN)
+    {
+        slots.resize(std::min(limit, slots.size())); // A scan already yields slot order
+    }
+    else if (limit < slots.size())
+    {
+        std::partial_sort(slots.begin(), slots.begin() + limit, slots.end(), before);
+        slots.resize(limit);
+    }
+    else
+    {
+        std::sort(slots.begin(), slots.end(), before);
+    }
 }
 
-// Save database to file
-bool MovieDatabase::saveToFile(const std::string &filename) const
+// First slot at or after 'from' that passes the filter (or 'end')
+static size_t skipToMatch(const QueryFilter &filter, size_t from, size_t end)
 {
-    std::ofstream file(filename, std::ios::binary);
-    if (!file.is_open())
+    while (from < end && !filter.matches(static_cast<int>(from)))
+    {
+        from++;
+    }
+    return from;
+}
+
+// Start a cursor: database-order scans stay lazy, anything else is
+// resolved to an ordered ID list up front
+MovieCursor MovieDatabase::openCursor(const MovieQuery &query) const
+{
+    MovieCursor cursor;
+    cursor.query = query;
+
+    QueryPlan plan = planQuery(query);
+    if (plan.access == QueryPlan::ACCESS_EMPTY)
+    {
+        return cursor;
+    }
+
+    if (query.getOrder() == MovieQuery::ORDER_DATABASE && plan.access == QueryPlan::ACCESS_SCAN)
+    {
+        cursor.lazyScan = true;
+        cursor.token.position = skipToMatch(QueryFilter(query, columns), 0, movies.size());
+        cursor.finished = cursor.token.position >= movies.size();
+        return cursor;
+    }
+
+    std::vector<const Movie *> results;
+    runQuery(query, results);
+    cursor.ids.reserve(results.size());
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        cursor.ids.push_back(results[i]->getId());
+    }
+    cursor.finished = cursor.ids.empty();
+    return cursor;
+}
+
+// Reopen a cursor where an earlier one stopped
+MovieCursor MovieDatabase::openCursor(const MovieQuery &query, const CursorToken &resume) const
+{
+    MovieCursor cursor = openCursor(query);
+    cursor.token = resume;
+
+    if (cursor.lazyScan)
+    {
+        // Continue after the last movie returned if it is still there
+        size_t position = resume.position;
+        if (resume.lastId >= 0)
+        {
+            std::unordered_map<int, int>::const_iterator it = idIndex.find(resume.lastId);
+            if (it != idIndex.end())
+            {
+                position = static_cast<size_t>(it->second) + 1;
+            }
+        }
+        cursor.token.position = skipToMatch(QueryFilter(query, columns), std::min(position, movies.size()),
+                                            movies.size());
+        size_t limit = query.getLimit() > 0 ? static_cast<size_t>(query.getLimit()) : movies.size() + 1;
+        cursor.finished = cursor.token.position >= movies.size() || resume.returned >= limit;
+        return cursor;
+    }
+
+    size_t position = resume.position;
+    bool stillThere = position > 0 && position <= cursor.ids.size() && cursor.ids[position - 1] == resume.lastId;
+    if (resume.lastId >= 0 && !stillThere)
+    {
+        std::vector<int>::const_iterator it = std::find(cursor.ids.begin(), cursor.ids.end(), resume.lastId);
+        if (it != cursor.ids.end())
+        {
+            position = static_cast<size_t>(it - cursor.ids.begin()) + 1;
+        }
+    }
+    cursor.token.position = std::min(position, cursor.ids.size());
+    cursor.finished = cursor.token.position >= cursor.ids.size();
+    return cursor;
+}
+
+// Hand out the next page of a cursor
+bool MovieDatabase::nextPage(MovieCursor &cursor, size_t pageSize, std::vector<const Movie *> &page) const
+{
+    page.clear();
+    if (cursor.finished)
     {
-        std::cerr << "Error: Could not open file for writing: " << filename << std::endl;
         return false;
     }
+    CursorToken &token = cursor.token;
 
-    // Write movie count
-    file.write(reinterpret_cast<const char *>(&movieCount), sizeof(movieCount));
+    if (cursor.lazyScan)
+    {
+        // Scan only until the page is full, then look ahead to the next
+        // match so hasMore() is exact
+        const MovieQuery &query = cursor.query;
+        QueryFilter filter(query, columns);
+        size_t limit = query.getLimit() > 0 ? static_cast<size_t>(query.getLimit()) : movies.size() + 1;
+        size_t slot = std::min(token.position, movies.size());
+        while (page.size() < pageSize && token.returned < limit && slot < movies.size())
+        {
+            if (filter.matches(static_cast<int>(slot)))
+            {
+                page.push_back(&movies[slot]);
+                token.lastId = movies[slot].getId();
+                token.returned++;
+            }
+            slot++;
+        }
+        token.position = skipToMatch(filter, slot, movies.size());
+        cursor.finished = token.position >= movies.size() || token.returned >= limit;
+        return !page.empty();
+    }
 
-    // Write each movie
-    for (int i = 0; i < movieCount; i++)
+    // Movies deleted since the cursor was opened are skipped
+    while (page.size() < pageSize && token.position < cursor.ids.size())
     {
-        // Write movie ID
-        int id = movies[i].getId();
-        file.write(reinterpret_cast<const char *>(&id), sizeof(id));
+        const Movie *movie = findMovieById(cursor.ids[token.position++]);
+        if (movie != nullptr)
+        {
+            page.push_back(movie);
+            token.lastId = movie->getId();
+            token.returned++;
+        }
+    }
+    cursor.finished = token.position >= cursor.ids.size();
+    return !page.empty();
+}
 
-        // Write movie name (length + string)
-        std::string name = movies[i].getName();
-        size_t nameLen = name.length();
-        file.write(reinterpret_cast<const char *>(&nameLen), sizeof(nameLen));
-        file.write(name.c_str(), nameLen);
+// Run a query and print the matching movies
+void MovieDatabase::displayQuery(const MovieQuery &query, const std::string &title) const
+{
+    std::vector<const Movie *> results;
+    QueryPlan plan;
+    runQuery(query, results, &plan);
 
-        // Write year
-        int year = movies[i].getYear();
-        file.write(reinterpret_cast<const char *>(&year), sizeof(year));
+    std::cout << "\n"
+              << std::string(100, '=') << std::endl;
+    std::cout << "                           " << title << std::endl;
+    std::cout << std::string(100, '=') << std::endl;
+    std::cout << std::left << std::setw(5) << "ID"
+              << std::setw(50) << "Movie Name"
+              << std::setw(6) << "Year"
+              << std::setw(15) << "Language"
+              << "Rating" << std::endl;
+    std::cout << std::string(100, '-') << std::endl;
 
-        // Write language (length + string)
-        std::string language = movies[i].getLanguage();
-        size_t langLen = language.length();
-        file.write(reinterpret_cast<const char *>(&langLen), sizeof(langLen));
-        file.write(language.c_str(), langLen);
+    MovieRenderer renderer;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        renderer.addRow(*results[i]);
+    }
+    renderer.flush();
+    if (results.empty())
+    {
+        std::cout << "No movies match the query" << std::endl;
+    }
+
+    std::cout << std::string(100, '-') << std::endl;
+    std::cout << "Total matches: " << results.size() << "   (plan: " << plan.describe() << ")" << std::endl;
+    std::cout << std::string(100, '=') << std::endl;
+}
 
-        // Write rating
-        double rating = movies[i].getRating();
-        file.write(reinterpret_cast<const char *>(&rating), sizeof(rating));
+// Return how many movies are in the database
+int MovieDatabase::getMovieCount() const
+{
+    return static_cast<int>(movies.size());
+}
+
+// Min/max/sum/count of all ratings; chunk partials are merged in chunk
+// order so the floating-point sum doesn't depend on the thread count
+RatingSummary MovieDatabase::getRatingSummary() const
+{
+    const std::vector<double> &ratings = columns.getRatings();
+    std::vector<RatingSummary> partial(ScanExecutor::chunkCount(ratings.size()));
+    executor.run(partial.size(), [&](size_t chunk) {
+        size_t begin, end;
+        ScanExecutor::chunkBounds(ratings.size(), chunk, begin, end);
+        partial[chunk] = ScanKernels::summarize(ratings.data() + begin, end - begin);
+    });
+
+    RatingSummary total = {0, 0.0, 0.0, 0.0};
+    for (size_t i = 0; i < partial.size(); i++)
+    {
+        total.min = (i == 0 || partial[i].min < total.min) ? partial[i].min : total.min;
+        total.max = (i == 0 || partial[i].max > total.max) ? partial[i].max : total.max;
+        total.sum += partial[i].sum;
+        total.count += partial[i].count;
     }
+    return total;
+}
 
-    file.close();
+// Min/max/sum/count of all release years
+YearSummary MovieDatabase::getYearSummary() const
+{
+    const std::vector<int> &years = columns.getYears();
+    std::vector<YearSummary> partial(ScanExecutor::chunkCount(years.size()));
+    executor.run(partial.size(), [&](size_t chunk) {
+        size_t begin, end;
+        ScanExecutor::chunkBounds(years.size(), chunk, begin, end);
+        partial[chunk] = ScanKernels::summarize(years.data() + begin, end - begin);
+    });
+
+    YearSummary total = {0, 0, 0, 0};
+    for (size_t i = 0; i < partial.size(); i++)
+    {
+        total.min = (i == 0 || partial[i].min < total.min) ? partial[i].min : total.min;
+        total.max = (i == 0 || partial[i].max > total.max) ? partial[i].max : total.max;
+        total.sum += partial[i].sum;
+        total.count += partial[i].count;
+    }
+    return total;
+}
+
+// Count movies rated between minRating and maxRating (inclusive)
+int MovieDatabase::countMoviesByRating(double minRating, double maxRating) const
+{
+    const std::vector<double> &ratings = columns.getRatings();
+    std::vector<size_t> partial(ScanExecutor::chunkCount(ratings.size()));
+    executor.run(partial.size(), [&](size_t chunk) {
+        size_t begin, end;
+        ScanExecutor::chunkBounds(ratings.size(), chunk, begin, end);
+        partial[chunk] = ScanKernels::countInRange(ratings.data() + begin, end - begin, minRating, maxRating);
+    });
+
+    size_t total = 0;
+    for (size_t i = 0; i < partial.size(); i++)
+    {
+        total += partial[i];
+    }
+    return static_cast<int>(total);
+}
+
+// Count movies released between fromYear and toYear (inclusive)
+int MovieDatabase::countMoviesByYear(int fromYear, int toYear) const
+{
+    const std::vector<int> &years = columns.getYears();
+    std::vector<size_t> partial(ScanExecutor::chunkCount(years.size()));
+    executor.run(partial.size(), [&](size_t chunk) {
+        size_t begin, end;
+        ScanExecutor::chunkBounds(years.size(), chunk, begin, end);
+        partial[chunk] = ScanKernels::countInRange(years.data() + begin, end - begin, fromYear, toYear);
+    });
+
+    size_t total = 0;
+    for (size_t i = 0; i < partial.size(); i++)
+    {
+        total += partial[i];
+    }
+    return static_cast<int>(total);
+}
+
+// Set how many threads full-table scans may use
+void MovieDatabase::setScanThreads(int threads)
+{
+    executor.setThreadCount(threads);
+}
+
+// Get how many threads full-table scans may use
+int MovieDatabase::getScanThreads() const
+{
+    return executor.getThreadCount();
+}
+
+const CatalogStats &MovieDatabase::getCatalogStats() const
+{
+    return stats;
+}
+
+unsigned long long MovieDatabase::getGeneration() const
+{
+    return generation;
+}
+
+QueryCache::Stats MovieDatabase::getQueryCacheStats() const
+{
+    return queryCache.getStats();
+}
+
+void MovieDatabase::setQueryCacheCapacity(size_t entries, size_t rows)
+{
+    queryCache.setCapacity(entries, rows);
+}
+
+void MovieDatabase::clearQueryCache()
+{
+    queryCache.clear();
+}
+
+// Get the next available ID
+int MovieDatabase::getNextId() const
+{
+    return nextId;
+}
+
+// Reserve storage (and index buckets) for a known number of movies
+void MovieDatabase::reserve(int count)
+{
+    if (count > 0)
+    {
+        movies.reserve(count);
+        columns.reserve(count);
+        idIndex.reserve(count);
+    }
+}
+
+// Get how many movies fit before the storage has to grow
+int MovieDatabase::getCapacity() const
+{
+    return static_cast<int>(movies.capacity());
+}
+
+// Import a pipe-delimited text file: parse in parallel, then add in file order
+bool MovieDatabase::importFile(const std::string &filename, ImportResult &result, int threads)
+{
+    result.imported = 0;
+    result.rejected = 0;
+    result.errors.clear();
+
+    std::vector<char> text;
+    if (!MovieImporter::readFile(filename, text))
+    {
+        return false;
+    }
+
+    std::vector<ParsedMovie> rows;
+    MovieImporter::parse(text.data(), text.size(), threads, rows, result.errors);
+
+    journalPaused = true; // Bulk load: saved in one go by the caller
+    reserve(static_cast<int>(movies.size() + rows.size()));
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        const ParsedMovie &row = rows[i];
+        if (emplaceMovie(TextView(row.name, row.nameLength), row.id, row.year,
+                         TextView(row.language, row.languageLength), row.rating))
+        {
+            result.imported++;
+        }
+        else
+        {
+            result.rejected++;
+        }
+    }
+    journalPaused = false;
+    return true;
+}
+
+// Load movies from text file into the database
+void MovieDatabase::initializeSampleData()
+{
+    ImportResult result;
+    if (!importFile("movies.txt", result))
+    {
+        std::cerr << "Error: Could not open movies.txt file!" << std::endl;
+        std::cerr << "Please ensure movies.txt exists in the program directory." << std::endl;
+        return;
+    }
+
+    for (size_t i = 0; i < result.errors.size(); i++)
+    {
+        std::cerr << "Warning: Skipping line " << result.errors[i].line << " of movies.txt: "
+                  << result.errors[i].message << std::endl;
+    }
+    if (result.rejected > 0)
+    {
+        std::cerr << "Warning: Skipped " << result.rejected << " movie(s) with duplicate IDs" << std::endl;
+    }
+
+    std::cout << "Successfully loaded " << result.imported << " movies from movies.txt" << std::endl;
+}
+
+// Save database to file in the versioned, memory-mappable format
+bool MovieDatabase::saveToFile(const std::string &filename) const
+{
+    if (!MovieFile::write(filename, movies, stats))
+    {
+        std::cerr << "Error: Could not write file: " << filename << std::endl;
+        return false;
+    }
     return true;
 }
 
-// Load database from file
+// Stream every movie through one exporter buffer
+bool MovieDatabase::exportMovies(std::ostream &out, MovieExporter::Format format) const
+{
+    MovieExporter exporter(out, format);
+    for (size_t i = 0; i < movies.size(); i++)
+    {
+        exporter.addRow(movies[i]);
+    }
+    return exporter.finish();
+}
+
+// Export to a temp file, then move it into place (MovieFile::replaceFile
+// never deletes the old export first)
+bool MovieDatabase::exportToFile(const std::string &filename, MovieExporter::Format format) const
+{
+    std::string tempName = filename + ".tmp";
+    bool written;
+    {
+        std::ofstream file(tempName, std::ios::binary | std::ios::trunc);
+        written = file.is_open() && exportMovies(file, format);
+    }
+    if (!written)
+    {
+        std::remove(tempName.c_str());
+    }
+    if (!written || !MovieFile::replaceFile(tempName, filename))
+    {
+        std::cerr << "Error: Could not write file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Load database from file, detecting the format from its first bytes,
+// then replay any edits journaled since the last checkpoint
 bool MovieDatabase::loadFromFile(const std::string &filename)
+{
+    bool loaded = false;
+    journalPaused = true;
+
+    if (!MovieFile::hasMagic(filename))
+    {
+        loaded = loadLegacyFile(filename);
+    }
+    else
+    {
+        MovieFile file;
+        if (file.open(filename))
+        {
+            // Clear current database and size the storage from the header count
+            int count = file.getCount();
+            movies.clear();
+            columns.clear();
+            idIndex.clear();
+            titleIndex.clear();
+            orderIndex.clear();
+            stats.clear();
+            nextId = 1;
+            generation++;
+            textPool.clear();
+            deadTextBytes = 0;
+            reserve(count);
+
+            // Take the saved statistics instead of recounting them movie by movie
+            statsPaused = file.readStats(stats);
+
+            // Straight from the mapping into the movie: no temporary strings
+            for (int i = 0; i < count; i++)
+            {
+                emplaceMovie(TextView(file.getNameData(i), file.getNameLength(i)), file.getId(i), file.getYear(i),
+                             TextView(file.getLanguageData(i), file.getLanguageLength(i)), file.getRating(i));
+            }
+            statsPaused = false;
+
+            // A file whose records were not all accepted (duplicate IDs) no
+            // longer matches its statistics
+            if (stats.getMovieCount() != static_cast<int>(movies.size()))
+            {
+                stats.clear();
+                for (size_t i = 0; i < movies.size(); i++)
+                {
+                    stats.add(movies[i]);
+                }
+            }
+            loaded = true;
+        }
+        else
+        {
+            std::cerr << "Error: " << filename << " is corrupt or from an unsupported version" << std::endl;
+        }
+    }
+
+    if (loaded)
+    {
+        replayJournal(filename);
+    }
+    journalPaused = false;
+    return loaded;
+}
+
+// Re-apply journaled edits; they are idempotent, so replaying records that
+// already reached the data file (crash between save and truncate) is harmless
+void MovieDatabase::replayJournal(const std::string &filename)
+{
+    std::vector<MovieJournal::Entry> entries;
+    MovieJournal::replay(filename + ".wal", entries);
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const MovieJournal::Entry &entry = entries[i];
+        switch (entry.operation)
+        {
+        case MovieJournal::OP_ADD:
+            emplaceMovie(entry.name, entry.id, entry.year, entry.language, entry.rating);
+            break;
+        case MovieJournal::OP_UPDATE:
+            updateMovie(entry.id, entry.name, entry.year, entry.language, entry.rating);
+            break;
+        case MovieJournal::OP_REMOVE:
+            removeMovie(entry.id);
+            break;
+        }
+    }
+}
+
+// Start logging edits to <filename>.wal
+bool MovieDatabase::openJournal(const std::string &filename)
+{
+    if (!journal.open(filename + ".wal"))
+    {
+        std::cerr << "Error: Could not open journal: " << filename << ".wal" << std::endl;
+        return false;
+    }
+    journalDataFile = filename;
+    return true;
+}
+
+// Fold the journal into the data file and stop logging
+void MovieDatabase::closeJournal()
+{
+    if (journal.isOpen())
+    {
+        checkpoint();
+        journal.close();
+    }
+}
+
+// Sync the journal to disk and checkpoint when it has grown large enough
+bool MovieDatabase::persistChanges()
+{
+    if (!journal.isOpen())
+    {
+        return false;
+    }
+    if (!journal.sync())
+    {
+        return false;
+    }
+    if (journal.getRecordCount() >= checkpointInterval)
+    {
+        return checkpoint();
+    }
+    return true;
+}
+
+// Rewrite the data file, then drop the journal records it now contains
+bool MovieDatabase::checkpoint()
+{
+    if (!journal.isOpen())
+    {
+        return false;
+    }
+    // The journal is only emptied once the new file is durably in place
+    if (!saveToFile(journalDataFile))
+    {
+        return false;
+    }
+    return journal.truncate();
+}
+
+// Set how many journal records trigger an automatic checkpoint
+void MovieDatabase::setCheckpointInterval(int records)
+{
+    if (records > 0)
+    {
+        checkpointInterval = records;
+    }
+}
+
+// Read one fixed-width field of a legacy file
+template <typename T>
+static bool readLegacyValue(std::ifstream &file, T &value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+// Read one length-prefixed string of a legacy file. The length comes from
+// the file, so it is checked against the bytes left before anything is
+// allocated for it.
+static bool readLegacyString(std::ifstream &file, std::streamoff fileSize, std::string &value)
+{
+    size_t length;
+    if (!readLegacyValue(file, length))
+    {
+        return false;
+    }
+    std::streamoff position = file.tellg();
+    if (position < 0 || length > static_cast<unsigned long long>(fileSize - position))
+    {
+        return false;
+    }
+    value.resize(length);
+    return length == 0 || static_cast<bool>(file.read(&value[0], length));
+}
+
+// Load database from a legacy (version 1) file
+bool MovieDatabase::loadLegacyFile(const std::string &filename)
 {
     std::ifstream file(filename, std::ios::binary);
     if (!file.is_open())
@@ -528,51 +1937,60 @@ bool MovieDatabase::loadFromFile(const std::string &filename)
         return false;
     }
 
+    // Work out the file size so a corrupt count can't trigger a huge reservation
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+
     // Read movie count
-    int count;
+    int count = -1;
     file.read(reinterpret_cast<char *>(&count), sizeof(count));
 
-    if (count < 0 || count > MAX_MOVIES)
+    // Every record takes at least id + year + rating + two length prefixes
+    const std::streamoff minRecordSize = 2 * sizeof(int) + sizeof(double) + 2 * sizeof(size_t);
+    if (!file || count < 0 || count > fileSize / minRecordSize)
     {
         std::cerr << "Error: Invalid movie count in file" << std::endl;
         file.close();
         return false;
     }
 
-    // Clear current database
-    movieCount = 0;
-
-    // Read each movie
+    // Read every movie before touching the database, so a truncated or
+    // damaged file is rejected as a whole instead of half loaded
+    std::vector<Movie> loaded;
+    loaded.reserve(count);
+    std::string name, language;
     for (int i = 0; i < count; i++)
     {
         int id, year;
         double rating;
-        std::string name, language;
-        size_t nameLen, langLen;
-
-        // Read movie ID
-        file.read(reinterpret_cast<char *>(&id), sizeof(id));
-
-        // Read movie name
-        file.read(reinterpret_cast<char *>(&nameLen), sizeof(nameLen));
-        name.resize(nameLen);
-        file.read(&name[0], nameLen);
-
-        // Read year
-        file.read(reinterpret_cast<char *>(&year), sizeof(year));
-
-        // Read language
-        file.read(reinterpret_cast<char *>(&langLen), sizeof(langLen));
-        language.resize(langLen);
-        file.read(&language[0], langLen);
-
-        // Read rating
-        file.read(reinterpret_cast<char *>(&rating), sizeof(rating));
-
-        // Add movie to database
-        addMovie(Movie(name, id, year, language, rating));
+        if (!readLegacyValue(file, id) || !readLegacyString(file, fileSize, name) ||
+            !readLegacyValue(file, year) || !readLegacyString(file, fileSize, language) ||
+            !readLegacyValue(file, rating))
+        {
+            std::cerr << "Error: " << filename << " is truncated or corrupt" << std::endl;
+            return false;
+        }
+        loaded.push_back(Movie(name, id, year, language, rating));
     }
-
     file.close();
+
+    // Clear current database and size the storage from the header count
+    movies.clear();
+    columns.clear();
+    idIndex.clear();
+    titleIndex.clear();
+    orderIndex.clear();
+    stats.clear();
+    nextId = 1;
+    generation++;
+    textPool.clear();
+    deadTextBytes = 0;
+    reserve(count);
+
+    for (size_t i = 0; i < loaded.size(); i++)
+    {
+        addMovie(std::move(loaded[i]));
+    }
     return true;
 }
@@ -2,34 +2,147 @@
 #define MOVIEDATABASE_H
 
 #include "Movie.h"
+#include "MovieJournal.h"
+#include "MovieImporter.h"
+#include "TitleIndex.h"
+#include "OrderIndex.h"
+#include "MovieColumns.h"
+#include "ScanKernels.h"
+#include "MovieQuery.h"
+#include "QueryCache.h"
+#include "CatalogStats.h"
+#include "MovieCursor.h"
+#include "MovieExporter.h"
+#include "ScanExecutor.h"
 #include <vector>
+#include <unordered_map>
+
+// One edit for MovieDatabase::applyBatch
+struct MovieEdit
+{
+    enum Type
+    {
+        EDIT_ADD,
+        EDIT_UPDATE,
+        EDIT_REMOVE
+    };
+
+    Type type;
+    int id;               // EDIT_ADD: 0 takes the next free ID
+    std::string name;     // EDIT_ADD / EDIT_UPDATE fields
+    int year;
+    std::string language;
+    double rating;
+};
+
+// Outcome of MovieDatabase::applyBatch
+struct BatchResult
+{
+    bool applied;         // False when an edit failed and nothing was changed
+    size_t failedEdit;    // Index of that edit
+    std::vector<int> ids; // ID each edit touched (the new ID for adds)
+};
+
+// One result of MovieDatabase::findSimilarNames
+struct TitleMatch
+{
+    const Movie *movie;
+    int distance; // Edits between the search term and the closest part of the title
+};
 
 // This class manages a collection of movies
 class MovieDatabase
 {
+public:
+    // How removeMovie closes the gap left by a deleted movie
+    enum RemovalMode
+    {
+        REMOVE_PRESERVE_ORDER, // Shift later movies down: keeps order, O(n)
+        REMOVE_SWAP_LAST       // Move the last movie into the hole: O(1), reorders
+    };
+
+    // Where movie names are kept
+    enum StorageMode
+    {
+        STORAGE_OWNED, // Each movie's name in its own heap block
+        STORAGE_POOLED // All names in large shared blocks (see StringPool)
+    };
+
 private:
-    static const int MAX_MOVIES = 100000; // Maximum capacity: 100,000 movies!
-    Movie *movies;                        // Dynamic array to store all movies (heap allocation)
-    int movieCount;                       // Keep track of how many movies we have
+    std::vector<Movie> movies;            // Growable array of all movies (no fixed capacity)
+    MovieColumns columns;                 // Same movies, one contiguous array per field
+    std::unordered_map<int, int> idIndex; // Movie ID -> slot in the movies array
+    TitleIndex titleIndex;                // Trigram index over movie names
+    OrderIndex orderIndex;                // Sorted (rating, id) and (year, id) indexes
+    CatalogStats stats;                   // Aggregates kept in step with every edit
+    bool statsPaused;                     // Set while loading a file that carries its stats
+    RemovalMode removalMode;              // Current delete strategy
+    MovieJournal journal;                 // Write-ahead log of edits (see openJournal)
+    MovieJournal::Entry journalEntry;     // Reused by logEdit so logging keeps its buffers
+    std::string journalDataFile;          // Data file the journal checkpoints into
+    int checkpointInterval;               // Journal records between automatic checkpoints
+    bool journalPaused;                   // Set while loading so loads aren't logged
+    mutable ScanExecutor executor;        // Thread pool for full-table scans
+    unsigned long long generation;        // Bumped by every edit; tags cached results
+    mutable QueryCache queryCache;        // Recent runQuery / findMoviesByName results
+    int nextId;                           // One past the highest ID added since the last load
+    StorageMode storageMode;              // Where new movies' names go
+    StringPool textPool;                  // Names of pooled movies
+    size_t deadTextBytes;                 // Pool bytes no movie points at any more
+
+    // Append a movie whose text is already stored the way storageMode wants
+    bool insertMovie(Movie &&added);
+
+    // Note that a pooled movie's text is about to be dropped, and repack
+    // the pool once most of it is dead
+    void retireText(const Movie &movie);
+    void compactText();
+
+    // Rebuild the ID index for slots [first, end)
+    void reindexFrom(int first);
+
+    // Turn movie IDs from an index into movie pointers
+    void resolveIds(const std::vector<int> &ids, std::vector<const Movie *> &results) const;
+    void resolveSlots(const std::vector<int> &slots, std::vector<const Movie *> &results) const;
+
+    // Uncached work behind findMoviesByName and runQuery
+    void findNameSlots(const std::string &lowerTerm, bool prefixOnly, std::vector<int> &slots) const;
+    void runQuerySlots(const MovieQuery &query, const QueryPlan &chosen, std::vector<int> &slots) const;
+
+    // Read the original (version 1) field-by-field movies.dat format; a
+    // truncated or damaged file is rejected without changing the database
+    bool loadLegacyFile(const std::string &filename);
+
+    // Append an edit to the journal when one is open
+    void logEdit(MovieJournal::Operation operation, const Movie &movie);
+
+    // Apply the edits in <filename>.wal on top of the loaded data
+    void replayJournal(const std::string &filename);
 
 public:
     // Constructor
     MovieDatabase();
 
-    // Destructor to free memory
-    ~MovieDatabase();
-
-    // Add a movie to the database
+    // Add a movie to the database. The rvalue overload takes over the
+    // movie's name block instead of copying it (in STORAGE_OWNED mode);
+    // emplaceMovie builds the movie in place, straight into the pool in
+    // STORAGE_POOLED mode. All return false if the ID is taken.
     bool addMovie(const Movie &movie);
+    bool addMovie(Movie &&movie);
+    bool emplaceMovie(TextView name, int id, int year, TextView language, double rating);
 
     // Remove a movie by ID
     bool removeMovie(int id);
 
+    // Choose whether deletes preserve iteration order (default) or run in O(1)
+    void setRemovalMode(RemovalMode mode);
+    RemovalMode getRemovalMode() const;
+
     // Update movie information
     bool updateMovie(int id, const std::string &name, int year, const std::string &language, double rating);
 
-    // Find a movie by ID
-    Movie *findMovieById(int id);
+    // Find a movie by ID (read-only: edits must go through updateMovie)
+    const Movie *findMovieById(int id) const;
 
     // Show all movies in the database
     void displayAllMovies() const;
@@ -40,6 +153,9 @@ public:
     // Add a method to get all unique languages
     void displayAvailableLanguages() const;
 
+    // Number of movies in a language (case-insensitive)
+    int getLanguageCount(const std::string &language) const;
+
     // Show movies in a specific language
     void displayMoviesByLanguage(const std::string &language) const;
 
@@ -49,22 +165,127 @@ public:
     // Search movie by name
     void searchMovieByName(const std::string &searchTerm) const;
 
+    // Collect movies whose name contains (or, with prefixOnly, starts with)
+    // the term, case-insensitively, in database order
+    void findMoviesByName(const std::string &term, std::vector<const Movie *> &results,
+                          bool prefixOnly = false) const;
+
+    // Typo-tolerant name search: up to 'limit' movies whose names come
+    // within maxDistance edits of the term (-1 picks a budget from the
+    // term's length), closest first and then by ID. Candidates come from
+    // the trigram index (see TitleIndex::findApproximate); terms too short
+    // for it to filter scan every name. Terms under three bytes only match
+    // exactly, in database order.
+    void findSimilarNames(const std::string &term, size_t limit, std::vector<TitleMatch> &results,
+                          int maxDistance = -1) const;
+
+    // The k highest rated / most recent movies, best first (O(log n + k))
+    void topK(int k, std::vector<const Movie *> &results) const;
+    void latestK(int k, std::vector<const Movie *> &results) const;
+
+    // Movies with a rating / year in an inclusive range, lowest first
+    void findMoviesByRating(double minRating, double maxRating, std::vector<const Movie *> &results) const;
+    void findMoviesByYear(int fromYear, int toYear, std::vector<const Movie *> &results) const;
+
+    // Pick the access path for a query: the index (name, rating or year)
+    // expected to yield the fewest candidates, or a column scan
+    QueryPlan planQuery(const MovieQuery &query) const;
+
+    // Run a query; results point into the database and stay valid until
+    // the next edit. The chosen plan is reported through 'plan' if given.
+    void runQuery(const MovieQuery &query, std::vector<const Movie *> &results,
+                  QueryPlan *plan = nullptr) const;
+
+    // Open a cursor over a query's results, either from the start or from
+    // a token saved off an earlier cursor
+    MovieCursor openCursor(const MovieQuery &query) const;
+    MovieCursor openCursor(const MovieQuery &query, const CursorToken &resume) const;
+
+    // Fetch the cursor's next (up to) pageSize rows; returns false when no
+    // rows were left. Pointers stay valid until the next edit.
+    bool nextPage(MovieCursor &cursor, size_t pageSize, std::vector<const Movie *> &page) const;
+
+    // Run a query and print its rows as a table under 'title'
+    void displayQuery(const MovieQuery &query, const std::string &title) const;
+
     // Get total number of movies
     int getMovieCount() const;
 
-    // Get next available ID
+    // Per-language, per-year and rating histogram counts plus rating
+    // min/max/mean, maintained on every edit and saved with the file
+    const CatalogStats &getCatalogStats() const;
+
+    // Statistics over the rating / year columns (vectorized scans)
+    RatingSummary getRatingSummary() const;
+    YearSummary getYearSummary() const;
+    int countMoviesByRating(double minRating, double maxRating) const;
+    int countMoviesByYear(int fromYear, int toYear) const;
+
+    // Threads used by full-table scans and aggregates (0 = one per core,
+    // 1 = serial). Results are the same for every setting.
+    void setScanThreads(int threads);
+    int getScanThreads() const;
+
+    // Repeated runQuery and findMoviesByName calls are answered from an
+    // LRU cache until the next edit. getGeneration changes on every edit
+    // (add, update, remove, batch, load).
+    unsigned long long getGeneration() const;
+    QueryCache::Stats getQueryCacheStats() const;
+    void setQueryCacheCapacity(size_t entries, size_t rows);
+    void clearQueryCache();
+
+    // Apply many edits in one pass, with the same outcome as making them
+    // one at a time in order, but all or nothing: if any edit would fail
+    // (add of a taken ID, update/remove of a missing one) the database is
+    // left untouched. Deletes are compacted in one sweep and the indexes
+    // are patched once at the end, so large batches cost O(n + edits).
+    bool applyBatch(const std::vector<MovieEdit> &edits, BatchResult &result);
+
+    // Choose where names are stored. Pooled storage packs them into large
+    // blocks: no per-movie allocation on load and a smaller footprint.
+    // Switching converts the movies already loaded.
+    void setStorageMode(StorageMode mode);
+    StorageMode getStorageMode() const;
+
+    // Get next available ID (O(1): one past the highest ID added since the
+    // last load, so IDs freed by removals are not handed out again)
     int getNextId() const;
 
-    // Check if database is full
-    bool isFull() const;
+    // Reserve room for at least 'count' movies ahead of a bulk load
+    void reserve(int count);
 
-    // Get maximum capacity
-    int getMaxCapacity() const;
+    // Get how many movies fit before the storage has to grow
+    int getCapacity() const;
 
-    // File persistence methods
+    // File persistence methods (see MovieFile.h for the on-disk format;
+    // loadFromFile also accepts the legacy version 1 format). Loading
+    // builds every movie and index from the file, so it costs O(n).
     bool saveToFile(const std::string &filename = "movies.dat") const;
     bool loadFromFile(const std::string &filename = "movies.dat");
 
+    // Write-ahead logging: once open, every add/update/remove is appended
+    // to <filename>.wal instead of rewriting the whole data file
+    bool openJournal(const std::string &filename = "movies.dat");
+    void closeJournal();
+
+    // Make logged edits durable; checkpoints once enough records pile up
+    bool persistChanges();
+
+    // Rewrite the data file from memory and empty the journal
+    bool checkpoint();
+
+    // Number of journal records that triggers an automatic checkpoint
+    void setCheckpointInterval(int records);
+
+    // Bulk-import a Name|ID|Year|Language|Rating text file, parsing it on
+    // 'threads' cores (0 = all); bad lines are reported in result.errors
+    bool importFile(const std::string &filename, ImportResult &result, int threads = 0);
+
+    // Write every movie, in database order, as CSV or JSON Lines for other
+    // programs to read (to a stream, or to a file replaced as a whole)
+    bool exportMovies(std::ostream &out, MovieExporter::Format format) const;
+    bool exportToFile(const std::string &filename, MovieExporter::Format format) const;
+
     // Load movies from movies.txt file into database
     void initializeSampleData();
 };
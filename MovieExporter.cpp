@@ -0,0 +1,64 @@
+#include "MovieExporter.h"
+
+MovieExporter::MovieExporter(std::ostream &out, Format format) : out(out), format(format)
+{
+    buffer.reserve(BLOCK_BYTES + 1024);
+    if (format == FORMAT_CSV)
+    {
+        buffer += "id,name,year,language,rating\n";
+    }
+}
+
+MovieExporter::~MovieExporter()
+{
+    finish();
+}
+
+// Format into the buffer; pass a full block on without flushing
+void MovieExporter::addRow(const Movie &movie)
+{
+    if (format == FORMAT_CSV)
+    {
+        movie.appendCsv(buffer);
+    }
+    else
+    {
+        movie.appendJson(buffer);
+    }
+    if (buffer.size() >= BLOCK_BYTES)
+    {
+        writeBlock();
+    }
+}
+
+void MovieExporter::writeBlock()
+{
+    out.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+bool MovieExporter::finish()
+{
+    if (!buffer.empty())
+    {
+        writeBlock();
+    }
+    out.flush();
+    return !out.fail();
+}
+
+bool MovieExporter::parseFormat(const std::string &name, Format &format)
+{
+    std::string folded = Movie::foldCase(name);
+    if (folded == "csv")
+    {
+        format = FORMAT_CSV;
+        return true;
+    }
+    if (folded == "jsonl" || folded == "json" || folded == "ndjson")
+    {
+        format = FORMAT_JSON_LINES;
+        return true;
+    }
+    return false;
+}
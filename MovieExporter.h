@@ -0,0 +1,50 @@
+#ifndef MOVIEEXPORTER_H
+#define MOVIEEXPORTER_H
+
+#include "Movie.h"
+#include <iostream>
+#include <string>
+
+// Streams movies out in a machine-readable format for other programs:
+// CSV (RFC 4180, with a header line) or JSON Lines (one object per line).
+// Records are formatted straight into one reusable buffer that is handed
+// to the stream in large blocks, so an export allocates nothing per row.
+class MovieExporter
+{
+public:
+    enum Format
+    {
+        FORMAT_CSV,
+        FORMAT_JSON_LINES
+    };
+
+    // Bytes gathered before they are written to the stream
+    static const size_t BLOCK_BYTES = 1024 * 1024;
+
+    // Starts the output (the CSV header line) right away
+    MovieExporter(std::ostream &out, Format format);
+
+    // Writes out whatever is still buffered
+    ~MovieExporter();
+
+    MovieExporter(const MovieExporter &) = delete;
+    MovieExporter &operator=(const MovieExporter &) = delete;
+
+    // Queue one movie's record
+    void addRow(const Movie &movie);
+
+    // Write the buffered records and flush; false if the stream failed
+    bool finish();
+
+    // Pick a format from a name such as "csv", "jsonl" or "json"
+    static bool parseFormat(const std::string &name, Format &format);
+
+private:
+    std::ostream &out;
+    Format format;
+    std::string buffer;
+
+    void writeBlock();
+};
+
+#endif // MOVIEEXPORTER_H
@@ -0,0 +1,456 @@
+#include "MovieFile.h"
+#include "LanguageDictionary.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+static const char MOVIE_FILE_MAGIC[4] = {'M', 'V', 'D', 'B'};
+
+// Start with nothing open
+MovieFile::MovieFile() : data(nullptr), size(0), mapped(false)
+{
+}
+
+// Release the mapping when the view goes away
+MovieFile::~MovieFile()
+{
+    close();
+}
+
+const MovieFileHeader *MovieFile::header() const
+{
+    return reinterpret_cast<const MovieFileHeader *>(data);
+}
+
+const MovieFileRecord &MovieFile::record(int index) const
+{
+    return reinterpret_cast<const MovieFileRecord *>(data + sizeof(MovieFileHeader))[index];
+}
+
+const char *MovieFile::heap() const
+{
+    return data + sizeof(MovieFileHeader) + header()->recordCount * sizeof(MovieFileRecord);
+}
+
+// Map the file and check that it is a complete, uncorrupted version 2 or 3 file
+bool MovieFile::open(const std::string &filename)
+{
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(MovieFileHeader)))
+    {
+        ::close(fd);
+        return false;
+    }
+    void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping stays valid after the descriptor is closed
+    if (addr == MAP_FAILED)
+    {
+        return false;
+    }
+    data = static_cast<const char *>(addr);
+    size = static_cast<size_t>(st.st_size);
+    mapped = true;
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    std::streamoff fileSize = file.tellg();
+    if (fileSize < static_cast<std::streamoff>(sizeof(MovieFileHeader)))
+    {
+        return false;
+    }
+    buffer.resize(static_cast<size_t>(fileSize));
+    file.seekg(0, std::ios::beg);
+    if (!file.read(&buffer[0], fileSize))
+    {
+        buffer.clear();
+        return false;
+    }
+    data = &buffer[0];
+    size = buffer.size();
+#endif
+
+    // Header must match and the sections must add up to the file size exactly
+    const MovieFileHeader *h = header();
+    uint64_t expected = sizeof(MovieFileHeader) +
+                        static_cast<uint64_t>(h->recordCount) * sizeof(MovieFileRecord) +
+                        h->stringHeapSize + h->statsSize;
+    if (std::memcmp(h->magic, MOVIE_FILE_MAGIC, sizeof(MOVIE_FILE_MAGIC)) != 0 ||
+        (h->version != 2 && h->version != VERSION) || (h->version == 2 && h->statsSize != 0) ||
+        h->recordCount > 0x7fffffffu || expected != size)
+    {
+        close();
+        return false;
+    }
+
+    const char *body = data + sizeof(MovieFileHeader);
+    if (checksum(body, size - sizeof(MovieFileHeader)) != h->checksum)
+    {
+        close();
+        return false;
+    }
+
+    // Every string reference must stay inside the heap
+    for (uint32_t i = 0; i < h->recordCount; i++)
+    {
+        const MovieFileRecord &r = record(static_cast<int>(i));
+        if (static_cast<uint64_t>(r.nameOffset) + r.nameLength > h->stringHeapSize ||
+            static_cast<uint64_t>(r.languageOffset) + r.languageLength > h->stringHeapSize)
+        {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Unmap (or free) the file contents
+void MovieFile::close()
+{
+#ifndef _WIN32
+    if (mapped && data != nullptr)
+    {
+        munmap(const_cast<char *>(data), size);
+    }
+#endif
+    std::vector<char>().swap(buffer);
+    data = nullptr;
+    size = 0;
+    mapped = false;
+}
+
+bool MovieFile::isOpen() const
+{
+    return data != nullptr;
+}
+
+int MovieFile::getCount() const
+{
+    return isOpen() ? static_cast<int>(header()->recordCount) : 0;
+}
+
+int MovieFile::getId(int index) const
+{
+    return record(index).id;
+}
+
+int MovieFile::getYear(int index) const
+{
+    return record(index).year;
+}
+
+double MovieFile::getRating(int index) const
+{
+    return record(index).rating;
+}
+
+const char *MovieFile::getNameData(int index) const
+{
+    return heap() + record(index).nameOffset;
+}
+
+int MovieFile::getNameLength(int index) const
+{
+    return static_cast<int>(record(index).nameLength);
+}
+
+const char *MovieFile::getLanguageData(int index) const
+{
+    return heap() + record(index).languageOffset;
+}
+
+int MovieFile::getLanguageLength(int index) const
+{
+    return static_cast<int>(record(index).languageLength);
+}
+
+// Materialize one record as a Movie
+Movie MovieFile::getMovie(int index) const
+{
+    const MovieFileRecord &r = record(index);
+    return Movie(TextView(heap() + r.nameOffset, r.nameLength), r.id, r.year,
+                 TextView(heap() + r.languageOffset, r.languageLength), r.rating);
+}
+
+// The statistics section follows the string heap
+bool MovieFile::readStats(CatalogStats &stats) const
+{
+    if (!isOpen() || header()->statsSize == 0)
+    {
+        return false;
+    }
+    return stats.deserialize(heap() + header()->stringHeapSize, header()->statsSize);
+}
+
+// Peek at the first four bytes to tell version 2/3 files from legacy ones
+bool MovieFile::hasMagic(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    char magic[4];
+    if (!file.read(magic, sizeof(magic)))
+    {
+        return false;
+    }
+    return std::memcmp(magic, MOVIE_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+// Size of the pieces write() hands to the file
+static const size_t WRITE_CHUNK_BYTES = 1 << 20;
+
+// Write one piece of the file body and fold it into the checksum
+static void writeBody(std::ofstream &file, MovieFile::Checksum &sum, const char *bytes, size_t length)
+{
+    sum.update(bytes, length);
+    file.write(bytes, length);
+}
+
+// Stream movies into a temp file, then rename it over the target so a
+// crash mid-write never leaves a half-written movies.dat behind. Only one
+// chunk of records or text is held at a time; the header, whose sizes and
+// checksum are known last, is written over its placeholder at the end.
+bool MovieFile::write(const std::string &filename, const std::vector<Movie> &movies, const CatalogStats &stats)
+{
+    std::string tempName = filename + ".tmp";
+    std::ofstream file(tempName, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    MovieFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    file.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    Checksum sum;
+
+    // Record table. Offsets follow the order the heap is written in below:
+    // each name, then its language the first time that language is used.
+    std::vector<long long> languageOffsets(LanguageDictionary::size(), -1);
+    std::vector<MovieFileRecord> records;
+    records.reserve(WRITE_CHUNK_BYTES / sizeof(MovieFileRecord));
+    uint64_t heapSize = 0;
+    for (size_t i = 0; i < movies.size(); i++)
+    {
+        const Movie &movie = movies[i];
+        records.resize(records.size() + 1);
+        MovieFileRecord &r = records.back();
+        std::memset(&r, 0, sizeof(r));
+        r.id = movie.getId();
+        r.year = movie.getYear();
+        r.rating = movie.getRating();
+
+        r.nameOffset = static_cast<uint32_t>(heapSize);
+        r.nameLength = static_cast<uint32_t>(movie.getNameView().size());
+        heapSize += r.nameLength;
+
+        long long &offset = languageOffsets[movie.getLanguageId()];
+        if (offset < 0)
+        {
+            offset = static_cast<long long>(heapSize);
+            heapSize += movie.getLanguage().size();
+        }
+        r.languageOffset = static_cast<uint32_t>(offset);
+        r.languageLength = static_cast<uint32_t>(movie.getLanguage().size());
+
+        if (records.size() == records.capacity() || i + 1 == movies.size())
+        {
+            writeBody(file, sum, reinterpret_cast<const char *>(records.data()),
+                      records.size() * sizeof(MovieFileRecord));
+            records.clear();
+        }
+    }
+
+    // String heap, in the same order
+    std::vector<bool> languageWritten(languageOffsets.size(), false);
+    std::string text;
+    text.reserve(WRITE_CHUNK_BYTES);
+    for (size_t i = 0; i < movies.size(); i++)
+    {
+        TextView name = movies[i].getNameView();
+        text.append(name.data(), name.size());
+        int languageId = movies[i].getLanguageId();
+        if (!languageWritten[languageId])
+        {
+            languageWritten[languageId] = true;
+            text += movies[i].getLanguage();
+        }
+        if (text.size() >= WRITE_CHUNK_BYTES || i + 1 == movies.size())
+        {
+            writeBody(file, sum, text.data(), text.size());
+            text.clear();
+        }
+    }
+
+    std::string statsBlock;
+    stats.serialize(statsBlock);
+    writeBody(file, sum, statsBlock.data(), statsBlock.size());
+
+    // Checksum covers the record table, the heap and the statistics
+    std::memcpy(h.magic, MOVIE_FILE_MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.recordCount = static_cast<uint32_t>(movies.size());
+    h.stringHeapSize = heapSize;
+    h.statsSize = static_cast<uint32_t>(statsBlock.size());
+    h.checksum = sum.finish();
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    file.close();
+
+    // Offsets are 32-bit, so a larger heap can't be saved
+    if (!file || heapSize > 0xffffffffu)
+    {
+        std::remove(tempName.c_str());
+        return false;
+    }
+
+    return replaceFile(tempName, filename);
+}
+
+// Force a file's contents to disk (flush() only hands them to the OS)
+static bool syncFile(const std::string &name)
+{
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(name.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                                nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    bool synced = FlushFileBuffers(handle) != 0;
+    CloseHandle(handle);
+    return synced;
+#else
+    int fd = ::open(name.c_str(), O_WRONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#endif
+}
+
+// Force a rename inside the file's directory to disk. Windows makes the
+// move itself durable (MOVEFILE_WRITE_THROUGH).
+static bool syncParentDirectory(const std::string &name)
+{
+#ifdef _WIN32
+    (void)name;
+    return true;
+#else
+    std::string::size_type slash = name.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : name.substr(0, slash));
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#endif
+}
+
+// The temp file's contents reach the disk before the move, and the move
+// before this returns, so a power loss can never leave 'filename' naming
+// unwritten data. The old file is never deleted first: until the move
+// succeeds it is still there, so a failed move can drop the temp file.
+bool MovieFile::replaceFile(const std::string &tempName, const std::string &filename)
+{
+    if (!syncFile(tempName))
+    {
+        std::remove(tempName.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    bool moved = MoveFileExA(tempName.c_str(), filename.c_str(),
+                             MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool moved = std::rename(tempName.c_str(), filename.c_str()) == 0;
+#endif
+    if (!moved)
+    {
+        std::remove(tempName.c_str());
+        return false;
+    }
+    return syncParentDirectory(filename);
+}
+
+// FNV-1a over 64-bit words (byte-wise for the tail), folded to 32 bits
+uint32_t MovieFile::checksum(const char *bytes, size_t length)
+{
+    Checksum sum;
+    sum.update(bytes, length);
+    return sum.finish();
+}
+
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+MovieFile::Checksum::Checksum() : hash(14695981039346656037ULL), pendingCount(0)
+{
+}
+
+// Whole words go into the hash as they complete; a partial word waits in
+// 'pending' for the next piece
+void MovieFile::Checksum::update(const char *bytes, size_t length)
+{
+    size_t i = 0;
+    if (pendingCount > 0)
+    {
+        for (; i < length && pendingCount < sizeof(pending); i++)
+        {
+            pending[pendingCount++] = static_cast<unsigned char>(bytes[i]);
+        }
+        if (pendingCount < sizeof(pending))
+        {
+            return;
+        }
+        uint64_t word;
+        std::memcpy(&word, pending, sizeof(word));
+        hash = (hash ^ word) * FNV_PRIME;
+        pendingCount = 0;
+    }
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+    for (; i < length; i++)
+    {
+        pending[pendingCount++] = static_cast<unsigned char>(bytes[i]);
+    }
+}
+
+// The bytes of a final partial word are hashed one at a time
+uint32_t MovieFile::Checksum::finish() const
+{
+    uint64_t result = hash;
+    for (size_t i = 0; i < pendingCount; i++)
+    {
+        result = (result ^ pending[i]) * FNV_PRIME;
+    }
+    return static_cast<uint32_t>(result ^ (result >> 32));
+}
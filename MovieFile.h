@@ -0,0 +1,130 @@
+#ifndef MOVIEFILE_H
+#define MOVIEFILE_H
+
+#include "Movie.h"
+#include "CatalogStats.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// On-disk layout of movies.dat (version 3). Integers are stored in host
+// (little-endian) byte order and every record has the same width, so the
+// file can be memory-mapped and queried in place:
+//
+//   MovieFileHeader                       32 bytes
+//   MovieFileRecord[recordCount]          32 bytes each (the offset table)
+//   string heap                           names and languages, no terminators
+//   catalog statistics                    statsSize bytes (CatalogStats::serialize)
+//
+// Records point into the string heap by offset/length. Languages are
+// written to the heap once and shared by every record that uses them.
+// Version 2 files are the same without the statistics (statsSize 0).
+struct MovieFileHeader
+{
+    char magic[4];           // "MVDB"
+    uint32_t version;        // MovieFile::VERSION
+    uint32_t recordCount;    // Number of MovieFileRecord entries
+    uint32_t statsSize;      // Bytes of statistics after the heap (was reserved, 0 in version 2)
+    uint64_t stringHeapSize; // Bytes of text after the record table
+    uint32_t checksum;       // MovieFile::checksum() of records + string heap + statistics
+    uint32_t reserved2;      // Always 0
+};
+
+struct MovieFileRecord
+{
+    int32_t id;
+    int32_t year;
+    double rating;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t languageOffset;
+    uint32_t languageLength;
+};
+
+// Read-only view of a version 2 or 3 movies.dat file. The file is mapped into
+// memory (or read in one go where mmap is unavailable) and individual
+// fields are read straight from the mapping without building Movie objects.
+// MovieDatabase only uses it as a loader, though: loadFromFile copies every
+// record into a Movie and rebuilds the indexes, so a database load is still
+// O(n) work per start (~3.3 s for 1M movies against ~20 ms to open, verify
+// and scan the mapping).
+class MovieFile
+{
+private:
+    const char *data;            // Start of the mapped file
+    size_t size;                 // Size of the mapping in bytes
+    std::vector<char> buffer;    // Backing storage when the file is not mmapped
+    bool mapped;                 // True when 'data' must be munmapped
+
+    const MovieFileHeader *header() const;
+    const MovieFileRecord &record(int index) const;
+    const char *heap() const;
+
+public:
+    static const uint32_t VERSION = 3;
+
+    MovieFile();
+    ~MovieFile();
+
+    // Open and validate a version 2 or 3 file (magic, version, sizes, checksum)
+    bool open(const std::string &filename);
+    void close();
+    bool isOpen() const;
+
+    // Number of movies stored in the file
+    int getCount() const;
+
+    // Field accessors for record 'index' (0 <= index < getCount())
+    int getId(int index) const;
+    int getYear(int index) const;
+    double getRating(int index) const;
+    const char *getNameData(int index) const;
+    int getNameLength(int index) const;
+    const char *getLanguageData(int index) const;
+    int getLanguageLength(int index) const;
+
+    // Build a full Movie object for record 'index'
+    Movie getMovie(int index) const;
+
+    // Restore the catalog statistics saved with the file; false when the
+    // file has none (version 2) or they don't parse
+    bool readStats(CatalogStats &stats) const;
+
+    // True when the file starts with the version 2/3 magic bytes
+    static bool hasMagic(const std::string &filename);
+
+    // Write movies and their statistics in version 3 format. Each section
+    // is streamed to a temp file in pieces (so memory use does not grow
+    // with the catalog), then the file is renamed into place.
+    static bool write(const std::string &filename, const std::vector<Movie> &movies, const CatalogStats &stats);
+
+    // Move a fully written temp file over 'filename' in one step, so the
+    // old file stays intact until the new one replaces it. The data and
+    // the rename are both on disk when this returns true; the temp file
+    // is removed if it fails before the move.
+    static bool replaceFile(const std::string &tempName, const std::string &filename);
+
+    // Checksum used to detect torn or corrupted files
+    static uint32_t checksum(const char *bytes, size_t length);
+
+    // The same checksum computed piece by piece: feeding it bytes in any
+    // split gives what checksum() gives for all of them at once
+    class Checksum
+    {
+    private:
+        uint64_t hash;
+        unsigned char pending[8]; // Start of a word not yet complete
+        size_t pendingCount;
+
+    public:
+        Checksum();
+        void update(const char *bytes, size_t length);
+        uint32_t finish() const;
+    };
+
+    // A mapping can't be shared between two owners
+    MovieFile(const MovieFile &) = delete;
+    MovieFile &operator=(const MovieFile &) = delete;
+};
+
+#endif // MOVIEFILE_H
@@ -0,0 +1,329 @@
+#include "MovieImporter.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+// Don't bother spinning up a thread for less text than this
+static const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+// Exact powers of ten for turning a digit string into a double
+static const double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                       1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
+// Work for one thread: a line-aligned slice of the input and what it produced
+struct ImportChunk
+{
+    const char *begin;
+    const char *end;
+    int lineCount;
+    std::vector<ParsedMovie> rows;
+    std::vector<ImportError> errors; // Line numbers relative to the chunk
+};
+
+// Skip spaces/tabs on both ends of [first, last)
+static void trim(const char *&first, const char *&last)
+{
+    while (first < last && (*first == ' ' || *first == '\t'))
+    {
+        first++;
+    }
+    while (last > first && (last[-1] == ' ' || last[-1] == '\t'))
+    {
+        last--;
+    }
+}
+
+static void addError(ImportChunk &chunk, int line, const char *message)
+{
+    ImportError error;
+    error.line = line;
+    error.message = message;
+    chunk.errors.push_back(error);
+}
+
+// Parse every line in a chunk
+static void parseChunk(ImportChunk &chunk)
+{
+    const char *p = chunk.begin;
+    int line = 0;
+
+    while (p < chunk.end)
+    {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', chunk.end - p));
+        if (eol == nullptr)
+        {
+            eol = chunk.end;
+        }
+        line++;
+
+        const char *last = eol;
+        if (last > p && last[-1] == '\r')
+        {
+            last--; // Windows line ending
+        }
+
+        if (last > p)
+        {
+            // Cut the line at its four delimiters
+            const char *fields[6];
+            int fieldCount = 1;
+            fields[0] = p;
+            for (const char *c = p; c < last && fieldCount < 6; c++)
+            {
+                if (*c == '|')
+                {
+                    fields[fieldCount++] = c + 1;
+                }
+            }
+
+            if (fieldCount != 5)
+            {
+                addError(chunk, line, "expected 5 fields: Name|ID|Year|Language|Rating");
+            }
+            else
+            {
+                ParsedMovie row;
+                const char *a, *b;
+
+                row.name = fields[0];
+                row.nameLength = static_cast<int>(fields[1] - 1 - fields[0]);
+                row.language = fields[3];
+                row.languageLength = static_cast<int>(fields[4] - 1 - fields[3]);
+
+                bool ok = true;
+                a = fields[1];
+                b = fields[2] - 1;
+                trim(a, b);
+                if (!MovieImporter::parseInt(a, b, row.id))
+                {
+                    addError(chunk, line, "invalid ID");
+                    ok = false;
+                }
+                a = fields[2];
+                b = fields[3] - 1;
+                trim(a, b);
+                if (ok && !MovieImporter::parseInt(a, b, row.year))
+                {
+                    addError(chunk, line, "invalid year");
+                    ok = false;
+                }
+                a = fields[4];
+                b = last;
+                trim(a, b);
+                if (ok && !MovieImporter::parseDouble(a, b, row.rating))
+                {
+                    addError(chunk, line, "invalid rating");
+                    ok = false;
+                }
+
+                if (ok)
+                {
+                    chunk.rows.push_back(row);
+                }
+            }
+        }
+
+        p = eol + 1;
+    }
+
+    chunk.lineCount = line;
+}
+
+// Split the text into line-aligned chunks, parse them in parallel and
+// stitch the results back together in file order
+void MovieImporter::parse(const char *text, size_t length, int threads,
+                          std::vector<ParsedMovie> &rows, std::vector<ImportError> &errors)
+{
+    rows.clear();
+    errors.clear();
+
+    if (threads <= 0)
+    {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    size_t maxChunks = length / MIN_CHUNK_BYTES + 1;
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+    if (static_cast<size_t>(threads) > maxChunks)
+    {
+        threads = static_cast<int>(maxChunks);
+    }
+
+    // Cut at the first newline after each even split point
+    std::vector<ImportChunk> chunks(threads);
+    const char *end = text + length;
+    const char *start = text;
+    for (int i = 0; i < threads; i++)
+    {
+        const char *stop = (i == threads - 1) ? end : text + length / threads * (i + 1);
+        if (stop < start)
+        {
+            stop = start;
+        }
+        if (stop < end)
+        {
+            const char *eol = static_cast<const char *>(std::memchr(stop, '\n', end - stop));
+            stop = eol ? eol + 1 : end;
+        }
+        chunks[i].begin = start;
+        chunks[i].end = stop;
+        chunks[i].lineCount = 0;
+        start = stop;
+    }
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++)
+    {
+        workers.push_back(std::thread(parseChunk, std::ref(chunks[i])));
+    }
+    parseChunk(chunks[0]);
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    // Merge in order, turning chunk-relative line numbers into file line numbers
+    size_t totalRows = 0;
+    for (int i = 0; i < threads; i++)
+    {
+        totalRows += chunks[i].rows.size();
+    }
+    rows.reserve(totalRows);
+
+    int firstLine = 0;
+    for (int i = 0; i < threads; i++)
+    {
+        rows.insert(rows.end(), chunks[i].rows.begin(), chunks[i].rows.end());
+        for (size_t e = 0; e < chunks[i].errors.size(); e++)
+        {
+            errors.push_back(chunks[i].errors[e]);
+            errors.back().line += firstLine;
+        }
+        firstLine += chunks[i].lineCount;
+    }
+}
+
+// Slurp a file into a buffer with a single read
+bool MovieImporter::readFile(const std::string &filename, std::vector<char> &contents)
+{
+    FILE *in = std::fopen(filename.c_str(), "rb");
+    if (in == nullptr)
+    {
+        return false;
+    }
+
+    contents.clear();
+    bool ok = std::fseek(in, 0, SEEK_END) == 0;
+    long size = ok ? std::ftell(in) : -1;
+    if (size > 0 && std::fseek(in, 0, SEEK_SET) == 0)
+    {
+        contents.resize(static_cast<size_t>(size));
+        ok = std::fread(&contents[0], 1, contents.size(), in) == contents.size();
+    }
+    else
+    {
+        ok = ok && size == 0;
+    }
+    std::fclose(in);
+    return ok;
+}
+
+// Optional sign followed by digits, rejecting overflow
+bool MovieImporter::parseInt(const char *first, const char *last, int &value)
+{
+    bool negative = false;
+    if (first < last && (*first == '-' || *first == '+'))
+    {
+        negative = (*first == '-');
+        first++;
+    }
+    if (first == last)
+    {
+        return false;
+    }
+
+    int64_t result = 0;
+    for (; first < last; first++)
+    {
+        if (*first < '0' || *first > '9')
+        {
+            return false;
+        }
+        result = result * 10 + (*first - '0');
+        if (result > 2147483648LL)
+        {
+            return false;
+        }
+    }
+    if (negative)
+    {
+        result = -result;
+    }
+    if (result > 2147483647LL)
+    {
+        return false;
+    }
+    value = static_cast<int>(result);
+    return true;
+}
+
+// Optional sign, digits, optional fraction; no exponents
+bool MovieImporter::parseDouble(const char *first, const char *last, double &value)
+{
+    bool negative = false;
+    if (first < last && (*first == '-' || *first == '+'))
+    {
+        negative = (*first == '-');
+        first++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;         // Significant digits kept in the mantissa
+    int fractionDigits = 0; // How many of those sit after the point
+    int extraIntDigits = 0; // Integer digits dropped for precision
+    bool seenDigit = false;
+    bool seenPoint = false;
+
+    for (; first < last; first++)
+    {
+        char c = *first;
+        if (c == '.' && !seenPoint)
+        {
+            seenPoint = true;
+            continue;
+        }
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        seenDigit = true;
+        if (digits < 18)
+        {
+            mantissa = mantissa * 10 + (c - '0');
+            digits++;
+            if (seenPoint)
+            {
+                fractionDigits++;
+            }
+        }
+        else if (!seenPoint)
+        {
+            extraIntDigits++;
+        }
+    }
+    if (!seenDigit)
+    {
+        return false;
+    }
+
+    double result = static_cast<double>(mantissa) / POWERS_OF_TEN[fractionDigits];
+    for (int i = 0; i < extraIntDigits; i++)
+    {
+        result *= 10.0;
+    }
+    value = negative ? -result : result;
+    return true;
+}
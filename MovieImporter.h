@@ -0,0 +1,56 @@
+#ifndef MOVIEIMPORTER_H
+#define MOVIEIMPORTER_H
+
+#include <string>
+#include <vector>
+
+// One successfully parsed line of a Name|ID|Year|Language|Rating file.
+// The name and language point into the caller's text buffer.
+struct ParsedMovie
+{
+    const char *name;
+    int nameLength;
+    int id;
+    int year;
+    const char *language;
+    int languageLength;
+    double rating;
+};
+
+// A line that could not be imported
+struct ImportError
+{
+    int line;            // 1-based line number in the source file
+    std::string message; // What was wrong with it
+};
+
+// Summary returned by MovieDatabase::importFile
+struct ImportResult
+{
+    int imported;                    // Movies added to the database
+    int rejected;                    // Parsed rows addMovie refused (duplicate ID)
+    std::vector<ImportError> errors; // Malformed lines, in file order
+};
+
+// Parser for the pipe-delimited movies.txt format. The text is split into
+// line-aligned chunks that are parsed on separate threads; fields are cut
+// out in place and numbers are parsed without allocating or throwing.
+class MovieImporter
+{
+public:
+    // Parse a whole buffer; rows and errors come back in file order.
+    // threads <= 0 means one per hardware core.
+    static void parse(const char *text, size_t length, int threads,
+                      std::vector<ParsedMovie> &rows, std::vector<ImportError> &errors);
+
+    // Read a whole file into memory in one go
+    static bool readFile(const std::string &filename, std::vector<char> &contents);
+
+    // Parse a decimal integer spanning exactly [first, last)
+    static bool parseInt(const char *first, const char *last, int &value);
+
+    // Parse a plain decimal number ("8", "-1.25", "9.3") spanning exactly [first, last)
+    static bool parseDouble(const char *first, const char *last, double &value);
+};
+
+#endif // MOVIEIMPORTER_H
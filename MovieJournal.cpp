@@ -0,0 +1,238 @@
+#include "MovieJournal.h"
+#include "MovieFile.h"
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Upper bound on one record's payload (two strings plus fixed fields)
+static const uint32_t MAX_PAYLOAD = 1u << 20;
+
+// Append raw bytes of a fixed-width value
+template <typename T>
+static void putValue(std::string &out, T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// Read a fixed-width value, failing if the payload is too short
+template <typename T>
+static bool getValue(const std::string &in, size_t &pos, T &value)
+{
+    if (pos + sizeof(value) > in.size())
+    {
+        return false;
+    }
+    std::memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+// Read a length-prefixed string
+static bool getString(const std::string &in, size_t &pos, std::string &value)
+{
+    uint32_t length;
+    if (!getValue(in, pos, length) || pos + length > in.size())
+    {
+        return false;
+    }
+    value.assign(in.data() + pos, length);
+    pos += length;
+    return true;
+}
+
+MovieJournal::MovieJournal() : file(nullptr), recordCount(0)
+{
+}
+
+MovieJournal::~MovieJournal()
+{
+    close();
+}
+
+// Cut a log back to 'length' bytes and force the cut to disk
+static bool cutFile(FILE *file, uint64_t length)
+{
+#ifdef _WIN32
+    return _chsize_s(_fileno(file), static_cast<__int64>(length)) == 0 && _commit(_fileno(file)) == 0;
+#else
+    return ftruncate(fileno(file), static_cast<off_t>(length)) == 0 && fsync(fileno(file)) == 0;
+#endif
+}
+
+// Open the log for appending; complete records are kept, but a torn tail
+// is cut off first, or every record appended after it would be lost
+// behind a record replay always stops at
+bool MovieJournal::open(const std::string &filename)
+{
+    close();
+    std::vector<Entry> entries;
+    uint64_t validLength = 0;
+    replay(filename, entries, validLength);
+
+    file = std::fopen(filename.c_str(), "ab");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    long length = std::fseek(file, 0, SEEK_END) == 0 ? std::ftell(file) : -1;
+    if (length < 0 || (static_cast<uint64_t>(length) > validLength && !cutFile(file, validLength)))
+    {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    path = filename;
+    recordCount = 0;
+    return true;
+}
+
+// Flush and close the log
+void MovieJournal::close()
+{
+    if (file != nullptr)
+    {
+        sync();
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+bool MovieJournal::isOpen() const
+{
+    return file != nullptr;
+}
+
+// Encode one edit and append it to the log
+bool MovieJournal::append(const Entry &entry)
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    scratch.clear();
+    putValue<uint8_t>(scratch, static_cast<uint8_t>(entry.operation));
+    putValue<int32_t>(scratch, entry.id);
+    putValue<int32_t>(scratch, entry.year);
+    putValue<double>(scratch, entry.rating);
+    putValue<uint32_t>(scratch, static_cast<uint32_t>(entry.name.size()));
+    scratch += entry.name;
+    putValue<uint32_t>(scratch, static_cast<uint32_t>(entry.language.size()));
+    scratch += entry.language;
+
+    uint32_t header[2];
+    header[0] = static_cast<uint32_t>(scratch.size());
+    header[1] = MovieFile::checksum(scratch.data(), scratch.size());
+
+    if (std::fwrite(header, sizeof(header), 1, file) != 1 ||
+        std::fwrite(scratch.data(), 1, scratch.size(), file) != scratch.size())
+    {
+        return false;
+    }
+    recordCount++;
+    return true;
+}
+
+// Flush the stdio buffer and ask the OS to write it to disk
+bool MovieJournal::sync()
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+    if (std::fflush(file) != 0)
+    {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Drop all records (called once their effects are in movies.dat)
+bool MovieJournal::truncate()
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+    std::fclose(file);
+    file = nullptr;
+
+    FILE *emptied = std::fopen(path.c_str(), "wb");
+    if (emptied == nullptr)
+    {
+        return false;
+    }
+    std::fclose(emptied);
+    return open(path);
+}
+
+int MovieJournal::getRecordCount() const
+{
+    return recordCount;
+}
+
+bool MovieJournal::replay(const std::string &filename, std::vector<Entry> &entries)
+{
+    uint64_t validLength;
+    return replay(filename, entries, validLength);
+}
+
+// Decode records until the end of the log or the first torn/corrupt record
+bool MovieJournal::replay(const std::string &filename, std::vector<Entry> &entries, uint64_t &validLength)
+{
+    entries.clear();
+    validLength = 0;
+    FILE *in = std::fopen(filename.c_str(), "rb");
+    if (in == nullptr)
+    {
+        return true; // No log: nothing to replay
+    }
+
+    std::string payload;
+    uint32_t header[2];
+    while (std::fread(header, sizeof(header), 1, in) == 1)
+    {
+        if (header[0] > MAX_PAYLOAD)
+        {
+            break; // Garbage length: treat as torn tail
+        }
+        payload.resize(header[0]);
+        if (header[0] > 0 && std::fread(&payload[0], 1, header[0], in) != header[0])
+        {
+            break; // Torn tail
+        }
+        if (MovieFile::checksum(payload.data(), payload.size()) != header[1])
+        {
+            break; // Corrupt tail
+        }
+
+        Entry entry;
+        uint8_t operation;
+        int32_t id, year;
+        size_t pos = 0;
+        if (!getValue(payload, pos, operation) || !getValue(payload, pos, id) ||
+            !getValue(payload, pos, year) || !getValue(payload, pos, entry.rating) ||
+            !getString(payload, pos, entry.name) || !getString(payload, pos, entry.language) ||
+            operation < OP_ADD || operation > OP_REMOVE)
+        {
+            break;
+        }
+        entry.operation = static_cast<Operation>(operation);
+        entry.id = id;
+        entry.year = year;
+        entries.push_back(entry);
+        validLength += sizeof(header) + header[0];
+    }
+
+    std::fclose(in);
+    return true;
+}
@@ -0,0 +1,81 @@
+#ifndef MOVIEJOURNAL_H
+#define MOVIEJOURNAL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Append-only write-ahead log of database edits. Each add, update or
+// remove is written as one small record, so the cost of persisting an edit
+// does not depend on catalog size. The full movies.dat is only rewritten
+// at checkpoints, after which the log is truncated.
+//
+// Record layout: uint32 payload length, uint32 checksum, payload
+//   payload = uint8 operation, int32 id, int32 year, double rating,
+//             uint32 name length, name, uint32 language length, language
+//
+// A crash can only leave a torn record at the end of the log; replay
+// detects it through the length/checksum and stops there, and open cuts
+// it off before appending so later records stay reachable.
+class MovieJournal
+{
+public:
+    enum Operation
+    {
+        OP_ADD = 1,
+        OP_UPDATE = 2,
+        OP_REMOVE = 3
+    };
+
+    // One logged edit (name/language/year/rating are unused for OP_REMOVE)
+    struct Entry
+    {
+        Operation operation;
+        int id;
+        int year;
+        double rating;
+        std::string name;
+        std::string language;
+    };
+
+private:
+    FILE *file;           // Log opened for appending
+    std::string path;     // Location of the log
+    int recordCount;      // Records written since the last truncate
+    std::string scratch;  // Reused encoding buffer
+
+public:
+    MovieJournal();
+    ~MovieJournal();
+
+    // Open (or create) the log for appending. Anything after the last
+    // complete record (a torn tail) is truncated away first.
+    bool open(const std::string &filename);
+    void close();
+    bool isOpen() const;
+
+    // Append one edit (buffered until sync)
+    bool append(const Entry &entry);
+
+    // Push buffered records to stable storage
+    bool sync();
+
+    // Empty the log after a checkpoint
+    bool truncate();
+
+    // Records appended since the log was opened or truncated
+    int getRecordCount() const;
+
+    // Read every complete record from a log; a missing file yields no
+    // entries. validLength is set to the byte offset where the last
+    // complete record ends.
+    static bool replay(const std::string &filename, std::vector<Entry> &entries);
+    static bool replay(const std::string &filename, std::vector<Entry> &entries, uint64_t &validLength);
+
+    // Only one writer may own the log file
+    MovieJournal(const MovieJournal &) = delete;
+    MovieJournal &operator=(const MovieJournal &) = delete;
+};
+
+#endif // MOVIEJOURNAL_H
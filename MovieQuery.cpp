@@ -0,0 +1,192 @@
+#include "MovieQuery.h"
+#include <cctype>
+#include <cstdio>
+#include <sstream>
+#include <utility>
+
+// Append "<tag><length>:<lowercase text>" so no text can run into the next field
+static void appendFoldedField(std::string &key, char tag, const std::string &text)
+{
+    key += tag;
+    key += std::to_string(text.size());
+    key += ':';
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        key += static_cast<char>(tolower(static_cast<unsigned char>(text[i])));
+    }
+}
+
+// Append a rating exactly (%.17g round-trips a double)
+static void appendExactNumber(std::string &key, double value)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.17g", value);
+    key += text;
+}
+
+// Start with no filters, database order and no limit
+MovieQuery::MovieQuery()
+    : hasLanguage(false), hasYears(false), fromYear(0), toYear(0), hasRatings(false), minRating(0.0),
+      maxRating(0.0), hasName(false), order(ORDER_DATABASE), maxRows(0)
+{
+}
+
+MovieQuery &MovieQuery::language(std::string language)
+{
+    hasLanguage = true;
+    languageName = std::move(language);
+    return *this;
+}
+
+MovieQuery &MovieQuery::years(int from, int to)
+{
+    hasYears = true;
+    fromYear = from;
+    toYear = to;
+    return *this;
+}
+
+MovieQuery &MovieQuery::ratings(double min, double max)
+{
+    hasRatings = true;
+    minRating = min;
+    maxRating = max;
+    return *this;
+}
+
+MovieQuery &MovieQuery::nameContains(std::string term)
+{
+    hasName = true;
+    nameTerm = std::move(term);
+    return *this;
+}
+
+MovieQuery &MovieQuery::orderBy(Order order)
+{
+    this->order = order;
+    return *this;
+}
+
+MovieQuery &MovieQuery::limit(int rows)
+{
+    maxRows = rows > 0 ? rows : 0;
+    return *this;
+}
+
+bool MovieQuery::filtersLanguage() const
+{
+    return hasLanguage;
+}
+
+const std::string &MovieQuery::getLanguage() const
+{
+    return languageName;
+}
+
+bool MovieQuery::filtersYears() const
+{
+    return hasYears;
+}
+
+int MovieQuery::getFromYear() const
+{
+    return fromYear;
+}
+
+int MovieQuery::getToYear() const
+{
+    return toYear;
+}
+
+bool MovieQuery::filtersRatings() const
+{
+    return hasRatings;
+}
+
+double MovieQuery::getMinRating() const
+{
+    return minRating;
+}
+
+double MovieQuery::getMaxRating() const
+{
+    return maxRating;
+}
+
+bool MovieQuery::filtersName() const
+{
+    return hasName;
+}
+
+const std::string &MovieQuery::getNameTerm() const
+{
+    return nameTerm;
+}
+
+MovieQuery::Order MovieQuery::getOrder() const
+{
+    return order;
+}
+
+int MovieQuery::getLimit() const
+{
+    return maxRows;
+}
+
+// Build the cache key: each set filter tagged by a letter, then order and limit
+std::string MovieQuery::normalizedKey() const
+{
+    std::string key;
+    if (hasLanguage)
+    {
+        appendFoldedField(key, 'L', languageName);
+    }
+    if (hasYears)
+    {
+        key += 'Y';
+        key += std::to_string(fromYear);
+        key += '-';
+        key += std::to_string(toYear);
+    }
+    if (hasRatings)
+    {
+        key += 'R';
+        appendExactNumber(key, minRating);
+        key += '-';
+        appendExactNumber(key, maxRating);
+    }
+    if (hasName)
+    {
+        appendFoldedField(key, 'N', nameTerm);
+    }
+    key += 'O';
+    key += std::to_string(static_cast<int>(order));
+    key += 'M';
+    key += std::to_string(maxRows);
+    return key;
+}
+
+// Describe the access path for the user
+std::string QueryPlan::describe() const
+{
+    std::ostringstream text;
+    switch (access)
+    {
+    case ACCESS_EMPTY:
+        return "no possible matches";
+    case ACCESS_NAME_INDEX:
+        text << "name index";
+        break;
+    case ACCESS_RATING_INDEX:
+        text << "rating index";
+        break;
+    case ACCESS_YEAR_INDEX:
+        text << "year index";
+        break;
+    case ACCESS_SCAN:
+        text << "column scan";
+        break;
+    }
+    text << " (~" << estimatedRows << " rows)";
+    return text.str();
+}
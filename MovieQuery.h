@@ -0,0 +1,92 @@
+#ifndef MOVIEQUERY_H
+#define MOVIEQUERY_H
+
+#include <string>
+#include <cstddef>
+
+// A combinable movie query: any mix of language, year range, rating range
+// and name substring filters, plus an ordering and a row limit. Unset
+// filters match everything. Build one with the chained setters and run it
+// with MovieDatabase::runQuery, e.g.
+//
+//     MovieQuery().language("english").years(2000, 2009).orderBy(MovieQuery::ORDER_RATING).limit(5)
+class MovieQuery
+{
+public:
+    // Result order; ties are broken by ascending movie ID
+    enum Order
+    {
+        ORDER_DATABASE, // Database (slot) order
+        ORDER_RATING,   // Highest rating first
+        ORDER_YEAR,     // Newest first
+        ORDER_NAME,     // Alphabetical, case-insensitive
+        ORDER_ID        // Ascending ID
+    };
+
+private:
+    bool hasLanguage;
+    std::string languageName;
+    bool hasYears;
+    int fromYear;
+    int toYear;
+    bool hasRatings;
+    double minRating;
+    double maxRating;
+    bool hasName;
+    std::string nameTerm;
+    Order order;
+    int maxRows; // 0 = no limit
+
+public:
+    MovieQuery();
+
+    // Filters (inclusive ranges; the name match is a case-insensitive
+    // substring). Text filters take their string by value and move it in.
+    MovieQuery &language(std::string language);
+    MovieQuery &years(int from, int to);
+    MovieQuery &ratings(double min, double max);
+    MovieQuery &nameContains(std::string term);
+
+    // Ordering and row limit (0 = all rows)
+    MovieQuery &orderBy(Order order);
+    MovieQuery &limit(int rows);
+
+    bool filtersLanguage() const;
+    const std::string &getLanguage() const;
+    bool filtersYears() const;
+    int getFromYear() const;
+    int getToYear() const;
+    bool filtersRatings() const;
+    double getMinRating() const;
+    double getMaxRating() const;
+    bool filtersName() const;
+    const std::string &getNameTerm() const;
+    Order getOrder() const;
+    int getLimit() const;
+
+    // Canonical form of the query: two queries with the same key return
+    // the same rows (text filters are folded to lowercase, unset filters
+    // are left out). Used as the result cache key.
+    std::string normalizedKey() const;
+};
+
+// How MovieDatabase will produce a query's candidate rows
+struct QueryPlan
+{
+    enum Access
+    {
+        ACCESS_EMPTY,        // A filter can't match anything: no work at all
+        ACCESS_NAME_INDEX,   // Trigram index on the name term
+        ACCESS_RATING_INDEX, // Rating range from the sorted rating index
+        ACCESS_YEAR_INDEX,   // Year range from the sorted year index
+        ACCESS_SCAN          // Vectorized scan over the columns
+    };
+
+    Access access;
+    size_t estimatedRows; // Candidates the access path is expected to yield
+
+    // Short description, e.g. "rating index (~12 rows)"
+    std::string describe() const;
+};
+
+#endif // MOVIEQUERY_H
@@ -0,0 +1,46 @@
+#include "MovieRenderer.h"
+
+MovieRenderer::MovieRenderer(std::ostream &out) : out(out)
+{
+    buffer.reserve(PAGE_BYTES + 256);
+}
+
+MovieRenderer::~MovieRenderer()
+{
+    flush();
+}
+
+// Same layout as the table headers printed by MovieDatabase
+void MovieRenderer::addTitle(const std::string &title)
+{
+    buffer += '\n';
+    buffer.append(100, '=');
+    buffer += "\n                           ";
+    buffer += title;
+    buffer += '\n';
+    buffer.append(100, '=');
+    buffer += "\nID   Movie Name                                        Year  Language       Rating\n";
+    buffer.append(100, '-');
+    buffer += '\n';
+}
+
+// Format into the buffer; pass a full page on without flushing
+void MovieRenderer::addRow(const Movie &movie)
+{
+    movie.appendInfo(buffer);
+    if (buffer.size() >= PAGE_BYTES)
+    {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+void MovieRenderer::flush()
+{
+    if (!buffer.empty())
+    {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    out.flush();
+}
@@ -0,0 +1,39 @@
+#ifndef MOVIERENDERER_H
+#define MOVIERENDERER_H
+
+#include "Movie.h"
+#include <iostream>
+#include <string>
+
+// Collects formatted table rows in one reusable buffer and hands them to
+// the stream a page at a time. Printing a large table then costs a few
+// big writes instead of a stream operation (and a flush) per field.
+class MovieRenderer
+{
+private:
+    std::ostream &out;
+    std::string buffer;
+
+public:
+    // Bytes gathered before they are passed on to the stream
+    static const size_t PAGE_BYTES = 64 * 1024;
+
+    explicit MovieRenderer(std::ostream &out = std::cout);
+
+    // Writes out whatever is still buffered
+    ~MovieRenderer();
+
+    MovieRenderer(const MovieRenderer &) = delete;
+    MovieRenderer &operator=(const MovieRenderer &) = delete;
+
+    // Queue the banner and column headings that open every movie table
+    void addTitle(const std::string &title);
+
+    // Queue one movie's row (same format as Movie::displayInfo)
+    void addRow(const Movie &movie);
+
+    // Pass the buffered rows on and flush the stream
+    void flush();
+};
+
+#endif // MOVIERENDERER_H
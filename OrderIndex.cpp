@@ -0,0 +1,113 @@
+#include "OrderIndex.h"
+#include <climits>
+
+// Index a movie under its current rating and year
+void OrderIndex::add(const Movie &movie)
+{
+    byRating.insert(std::make_pair(movie.getRating(), movie.getId()));
+    byYear.insert(std::make_pair(movie.getYear(), movie.getId()));
+    ratingCounts[movie.getRating()]++;
+    yearCounts[movie.getYear()]++;
+}
+
+// Unindex a movie; must be called before its rating or year changes
+void OrderIndex::remove(const Movie &movie)
+{
+    if (byRating.erase(std::make_pair(movie.getRating(), movie.getId())) != 0 &&
+        --ratingCounts[movie.getRating()] == 0)
+    {
+        ratingCounts.erase(movie.getRating());
+    }
+    if (byYear.erase(std::make_pair(movie.getYear(), movie.getId())) != 0 &&
+        --yearCounts[movie.getYear()] == 0)
+    {
+        yearCounts.erase(movie.getYear());
+    }
+}
+
+void OrderIndex::clear()
+{
+    byRating.clear();
+    byYear.clear();
+    ratingCounts.clear();
+    yearCounts.clear();
+}
+
+size_t OrderIndex::size() const
+{
+    return byRating.size();
+}
+
+template <typename Set>
+void OrderIndex::highest(const Set &index, int k, std::vector<int> &ids)
+{
+    typename Set::const_iterator groupEnd = index.end();
+    while (k > 0 && groupEnd != index.begin())
+    {
+        // Find the first entry sharing the key of the entry before groupEnd
+        typename Set::const_iterator last = groupEnd;
+        --last;
+        typename Set::const_iterator groupStart = index.lower_bound(std::make_pair(last->first, INT_MIN));
+        for (typename Set::const_iterator it = groupStart; it != groupEnd && k > 0; ++it, --k)
+        {
+            ids.push_back(it->second);
+        }
+        groupEnd = groupStart;
+    }
+}
+
+// Up to k IDs, best rated first
+void OrderIndex::topRated(int k, std::vector<int> &ids) const
+{
+    highest(byRating, k, ids);
+}
+
+// Up to k IDs, newest first
+void OrderIndex::latest(int k, std::vector<int> &ids) const
+{
+    highest(byYear, k, ids);
+}
+
+// IDs rated between low and high (inclusive), lowest rating first
+void OrderIndex::ratingRange(double low, double high, std::vector<int> &ids) const
+{
+    std::set<std::pair<double, int> >::const_iterator it = byRating.lower_bound(std::make_pair(low, INT_MIN));
+    for (; it != byRating.end() && it->first <= high; ++it)
+    {
+        ids.push_back(it->second);
+    }
+}
+
+// IDs released between low and high (inclusive), earliest first
+void OrderIndex::yearRange(int low, int high, std::vector<int> &ids) const
+{
+    std::set<std::pair<int, int> >::const_iterator it = byYear.lower_bound(std::make_pair(low, INT_MIN));
+    for (; it != byYear.end() && it->first <= high; ++it)
+    {
+        ids.push_back(it->second);
+    }
+}
+
+// Ratings in [low, high], capped at limit
+size_t OrderIndex::countRatingRange(double low, double high, size_t limit) const
+{
+    size_t count = 0;
+    std::map<double, size_t>::const_iterator it = ratingCounts.lower_bound(low);
+    for (; it != ratingCounts.end() && it->first <= high && count < limit; ++it)
+    {
+        count += it->second;
+    }
+    return count < limit ? count : limit;
+}
+
+// Years in [low, high], capped at limit
+size_t OrderIndex::countYearRange(int low, int high, size_t limit) const
+{
+    size_t count = 0;
+    std::map<int, size_t>::const_iterator it = yearCounts.lower_bound(low);
+    for (; it != yearCounts.end() && it->first <= high && count < limit; ++it)
+    {
+        count += it->second;
+    }
+    return count < limit ? count : limit;
+}
@@ -0,0 +1,53 @@
+#ifndef ORDERINDEX_H
+#define ORDERINDEX_H
+
+#include "Movie.h"
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+// Sorted secondary indexes on (rating, id) and (year, id). Both are
+// balanced search trees kept up to date on every edit, so the k best or
+// newest movies, or every movie in a rating/year range, come out in
+// O(log n + k) without touching the rest of the table. Results are movie
+// IDs; ties on the key are broken by ascending ID.
+class OrderIndex
+{
+private:
+    std::set<std::pair<double, int> > byRating; // (rating, id), ascending
+    std::set<std::pair<int, int> > byYear;      // (year, id), ascending
+    std::map<double, size_t> ratingCounts;      // Movies per distinct rating
+    std::map<int, size_t> yearCounts;           // Movies per distinct year
+
+    // Walk down from the top key, emitting up to k IDs; equal keys keep
+    // ascending ID order
+    template <typename Set>
+    static void highest(const Set &index, int k, std::vector<int> &ids);
+
+public:
+    // Index / unindex one movie under its current rating and year
+    void add(const Movie &movie);
+    void remove(const Movie &movie);
+
+    // Drop everything
+    void clear();
+
+    size_t size() const;
+
+    // Up to k IDs, highest rating (or newest year) first
+    void topRated(int k, std::vector<int> &ids) const;
+    void latest(int k, std::vector<int> &ids) const;
+
+    // IDs with a key in [low, high], lowest key first
+    void ratingRange(double low, double high, std::vector<int> &ids) const;
+    void yearRange(int low, int high, std::vector<int> &ids) const;
+
+    // Number of keys in [low, high], counting no further than 'limit'.
+    // Walks the distinct keys rather than the movies, so even wide ranges
+    // are cheap to size up for the query planner.
+    size_t countRatingRange(double low, double high, size_t limit) const;
+    size_t countYearRange(int low, int high, size_t limit) const;
+};
+
+#endif // ORDERINDEX_H
@@ -0,0 +1,110 @@
+#include "QueryCache.h"
+#include <utility>
+
+QueryCache::QueryCache()
+    : generation(0), maxEntries(DEFAULT_ENTRIES), maxRows(DEFAULT_ROWS), rows(0), hits(0), misses(0)
+{
+}
+
+void QueryCache::adopt(unsigned long long current)
+{
+    if (current != generation)
+    {
+        entries.clear();
+        lookup.clear();
+        rows = 0;
+        generation = current;
+    }
+}
+
+void QueryCache::evict()
+{
+    while (!entries.empty() && (entries.size() > maxEntries || rows > maxRows))
+    {
+        Entry &oldest = entries.back();
+        rows -= oldest.slots.size();
+        lookup.erase(oldest.key);
+        entries.pop_back();
+    }
+}
+
+bool QueryCache::find(const std::string &key, unsigned long long current, std::vector<int> &slots,
+                      QueryPlan *plan)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    if (maxEntries == 0)
+    {
+        return false; // Disabled: not counted as a miss
+    }
+    adopt(current);
+    std::unordered_map<std::string, std::list<Entry>::iterator>::iterator it = lookup.find(key);
+    if (it == lookup.end())
+    {
+        misses++;
+        return false;
+    }
+
+    // Move to the front: most recently used
+    entries.splice(entries.begin(), entries, it->second);
+    slots = it->second->slots;
+    if (plan != nullptr)
+    {
+        *plan = it->second->plan;
+    }
+    hits++;
+    return true;
+}
+
+void QueryCache::store(const std::string &key, unsigned long long current, const std::vector<int> &slots,
+                       const QueryPlan &plan)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    adopt(current);
+    if (maxEntries == 0 || slots.size() > maxRows || lookup.find(key) != lookup.end())
+    {
+        return;
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.slots = slots;
+    entry.plan = plan;
+    entries.push_front(std::move(entry));
+    lookup[key] = entries.begin();
+    rows += slots.size();
+    evict();
+}
+
+void QueryCache::setCapacity(size_t entryLimit, size_t rowLimit)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    maxEntries = entryLimit;
+    maxRows = rowLimit;
+    evict();
+}
+
+void QueryCache::clear()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    lookup.clear();
+    rows = 0;
+}
+
+QueryCache::Stats QueryCache::getStats() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    Stats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.entries = entries.size();
+    stats.rows = rows;
+    return stats;
+}
+
+void QueryCache::resetStats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    hits = 0;
+    misses = 0;
+}
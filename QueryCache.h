@@ -0,0 +1,79 @@
+#ifndef QUERYCACHE_H
+#define QUERYCACHE_H
+
+#include "MovieQuery.h"
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Bounded LRU cache of query results, keyed by a normalized query string.
+// Results are stored as movie slots together with the database generation
+// they were computed at; the database bumps its generation on every edit,
+// so a lookup under a newer generation drops everything cached before it
+// and a stale result is never returned. Lookups may come from several
+// reader threads at once, so every operation takes the cache's lock.
+class QueryCache
+{
+public:
+    // Counters since construction (or the last resetStats)
+    struct Stats
+    {
+        size_t hits;
+        size_t misses;
+        size_t entries; // Results currently cached
+        size_t rows;    // Slots held by those results
+    };
+
+private:
+    struct Entry
+    {
+        std::string key;
+        std::vector<int> slots;
+        QueryPlan plan;
+    };
+
+    std::list<Entry> entries; // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+    unsigned long long generation; // Database generation the entries belong to
+    size_t maxEntries;             // 0 disables the cache
+    size_t maxRows;                // Total slots kept across all entries
+    size_t rows;
+    size_t hits, misses;
+    mutable std::mutex lock;
+
+    // Forget every entry if the database has moved on (lock held)
+    void adopt(unsigned long long current);
+
+    // Drop least recently used entries until both limits hold (lock held)
+    void evict();
+
+public:
+    static const size_t DEFAULT_ENTRIES = 64;
+    static const size_t DEFAULT_ROWS = 1024 * 1024;
+
+    QueryCache();
+
+    QueryCache(const QueryCache &) = delete;
+    QueryCache &operator=(const QueryCache &) = delete;
+
+    // Copy out the slots (and plan, if asked for) cached under 'key' for
+    // this generation. Counts a hit or a miss.
+    bool find(const std::string &key, unsigned long long current, std::vector<int> &slots, QueryPlan *plan);
+
+    // Remember a result computed at this generation. Results larger than
+    // the row limit are not kept.
+    void store(const std::string &key, unsigned long long current, const std::vector<int> &slots,
+               const QueryPlan &plan);
+
+    // Limit the number of cached results and the slots they hold in total
+    // (0 entries turns caching off)
+    void setCapacity(size_t entryLimit, size_t rowLimit);
+
+    void clear();
+    Stats getStats() const;
+    void resetStats();
+};
+
+#endif // QUERYCACHE_H
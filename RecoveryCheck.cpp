@@ -0,0 +1,124 @@
+// Crash-recovery checks for movies.dat and its write-ahead journal.
+//
+// Each check damages a scratch data file or journal the way a crash or a
+// bad disk would, then drives the database through load / edit / persist /
+// reload and verifies that nothing acknowledged as saved goes missing:
+//   - a torn record at the end of the journal (the writer died mid-append)
+//   - a record with a bad checksum at the end of the journal
+//   - legacy (version 1) files that are truncated or claim a huge string
+// Prints one line per check and exits non-zero if any fails.
+//
+// Usage: RecoveryCheck [file]
+//        (default: recovery_check.dat, removed afterwards)
+
+#include "MovieDatabase.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+void removeFiles(const string& filename) {
+    remove(filename.c_str());
+    remove((filename + ".wal").c_str());
+}
+
+// Save a two-movie catalog with an empty journal
+void writeCatalog(const string& filename) {
+    removeFiles(filename);
+    MovieDatabase database;
+    database.emplaceMovie("Seed One", 1, 1999, "English", 7.5);
+    database.emplaceMovie("Seed Two", 2, 2004, "French", 8.1);
+    database.saveToFile(filename);
+}
+
+// Append raw bytes to the journal, as a crash mid-append would leave them
+void appendToJournal(const string& filename, const string& bytes) {
+    ofstream journal((filename + ".wal").c_str(), ios::binary | ios::app);
+    journal.write(bytes.data(), bytes.size());
+}
+
+// Reload after the damage, add a movie, persist it, reload again: the new
+// movie must survive next to the two saved ones
+bool editAfterDamage(const string& filename) {
+    {
+        MovieDatabase database;
+        if (!database.loadFromFile(filename) || database.getMovieCount() != 2 || !database.openJournal(filename)) {
+            return false;
+        }
+        database.setCheckpointInterval(1000); // Keep the edit in the journal
+        if (!database.emplaceMovie("After Crash", 3, 2020, "Korean", 6.9) || !database.persistChanges()) {
+            return false;
+        }
+    }
+    MovieDatabase reloaded;
+    return reloaded.loadFromFile(filename) && reloaded.getMovieCount() == 3 && reloaded.findMovieById(3) != nullptr;
+}
+
+// One legacy record: id, name length + name, year, language length +
+// language, rating (lengths are size_t, as the old writer stored them)
+string legacyRecord(int id, const string& name, size_t nameLength, int year, const string& language, double rating) {
+    string record(reinterpret_cast<const char*>(&id), sizeof(id));
+    record.append(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+    record += name;
+    record.append(reinterpret_cast<const char*>(&year), sizeof(year));
+    size_t languageLength = language.size();
+    record.append(reinterpret_cast<const char*>(&languageLength), sizeof(languageLength));
+    record += language;
+    record.append(reinterpret_cast<const char*>(&rating), sizeof(rating));
+    return record;
+}
+
+// Load a legacy file into a database that already holds one movie; a bad
+// file must fail and leave that movie alone, a good one must replace it
+bool loadLegacy(const string& filename, int count, const string& records, bool shouldLoad) {
+    {
+        ofstream file(filename.c_str(), ios::binary | ios::trunc);
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(records.data(), records.size());
+    }
+    MovieDatabase database;
+    database.emplaceMovie("Already Here", 99, 2001, "English", 5.0);
+    bool loaded = database.loadFromFile(filename);
+    if (!shouldLoad) {
+        return !loaded && database.getMovieCount() == 1 && database.findMovieById(99) != nullptr;
+    }
+    return loaded && database.getMovieCount() == count && database.findMovieById(99) == nullptr;
+}
+
+bool report(const char* name, bool passed) {
+    cout << (passed ? "PASS  " : "FAIL  ") << name << endl;
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    string filename = argc > 1 ? argv[1] : "recovery_check.dat";
+    int failed = 0;
+
+    // Header claims a 40-byte payload but only 6 bytes made it to disk
+    writeCatalog(filename);
+    uint32_t tornHeader[2] = {40, 0x12345678u};
+    appendToJournal(filename, string(reinterpret_cast<const char*>(tornHeader), sizeof(tornHeader)) + "abcdef");
+    failed += !report("torn journal tail is cut before new records", editAfterDamage(filename));
+
+    // A complete-looking record whose checksum does not match
+    writeCatalog(filename);
+    uint32_t badHeader[2] = {8, 0x12345678u};
+    appendToJournal(filename, string(reinterpret_cast<const char*>(badHeader), sizeof(badHeader)) + "garbage!");
+    failed += !report("corrupt journal tail is cut before new records", editAfterDamage(filename));
+
+    removeFiles(filename);
+    string first = legacyRecord(1, "Old One", 7, 1980, "English", 6.5);
+    string second = legacyRecord(2, "Old Two", 7, 1990, "Italian", 7.5);
+    failed += !report("legacy file loads", loadLegacy(filename, 2, first + second, true));
+    failed += !report("truncated legacy file is rejected whole",
+                      loadLegacy(filename, 2, first + second.substr(0, second.size() - 5), false));
+    failed += !report("legacy string longer than the file is rejected",
+                      loadLegacy(filename, 2, first + legacyRecord(2, "Old Two", size_t(1) << 40, 1990, "Italian", 7.5),
+                                 false));
+
+    removeFiles(filename);
+    return failed == 0 ? 0 : 1;
+}
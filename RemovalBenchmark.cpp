@@ -0,0 +1,79 @@
+// Benchmark for removing movies.
+//
+// Builds a synthetic catalog and deletes half of it, by ID in random
+// order, once per removal mode: REMOVE_PRESERVE_ORDER shifts every later
+// movie down one slot, REMOVE_SWAP_LAST moves the last movie into the hole.
+// Reports the total and per-delete time, and checks that both modes keep
+// the same movies and that only the first keeps them in insertion order.
+//
+// Usage: RemovalBenchmark [movies]
+//        (default: 100000 movies)
+
+#include "MovieDatabase.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+string formatTime(double value, const char* unit) {
+    ostringstream cell;
+    cell << fixed << setprecision(1) << value << " " << unit;
+    return cell.str();
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+
+    // Half of the IDs, shuffled
+    vector<int> victims;
+    for (int id = 1; id <= count; id++) {
+        victims.push_back(id);
+    }
+    srand(7);
+    for (size_t i = victims.size() - 1; i > 0; i--) {
+        swap(victims[i], victims[static_cast<size_t>(rand()) % (i + 1)]);
+    }
+    victims.resize(victims.size() / 2);
+
+    const char* labels[] = {"preserve order (shift)", "swap last"};
+    MovieDatabase::RemovalMode modes[] = {MovieDatabase::REMOVE_PRESERVE_ORDER, MovieDatabase::REMOVE_SWAP_LAST};
+    vector<int> keptIds[2];
+    cout << "Deleting " << victims.size() << " of " << count << " movies in random order" << endl;
+    cout << left << setw(26) << "Mode" << setw(14) << "total" << setw(16) << "per delete" << "in order" << endl;
+    for (int m = 0; m < 2; m++) {
+        MovieDatabase database;
+        database.reserve(count);
+        for (int id = 1; id <= count; id++) {
+            database.emplaceMovie("Movie title number " + to_string(id), id, 1900 + id % 125, "English",
+                                  (id % 91 + 10) / 10.0);
+        }
+        database.setRemovalMode(modes[m]);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (size_t i = 0; i < victims.size(); i++) {
+            database.removeMovie(victims[i]);
+        }
+        chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+        vector<const Movie*> remaining;
+        database.runQuery(MovieQuery(), remaining);
+        bool ordered = true;
+        for (size_t i = 0; i < remaining.size(); i++) {
+            keptIds[m].push_back(remaining[i]->getId());
+            ordered = ordered && (i == 0 || remaining[i - 1]->getId() < remaining[i]->getId());
+        }
+        sort(keptIds[m].begin(), keptIds[m].end());
+
+        cout << setw(26) << labels[m] << setw(14) << formatTime(elapsed.count(), "ms") << setw(16)
+             << formatTime(elapsed.count() * 1000000 / victims.size(), "ns") << (ordered ? "yes" : "no") << endl;
+    }
+    cout << "Same movies kept by both modes: " << (keptIds[0] == keptIds[1] ? "yes" : "NO") << " ("
+         << keptIds[0].size() << ")" << endl;
+    return keptIds[0] == keptIds[1] ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+// Benchmark for table rendering.
+//
+// Prints a synthetic catalog with displayAllMovies and, for comparison,
+// with the old one-stream-operation-per-field row printer (std::endl after
+// every row). Table output goes to stdout, timings to stderr, so run it
+// with stdout redirected:
+//
+// Usage: RenderBenchmark [movies] > /dev/null
+//        (default: 100000 movies)
+
+#include "MovieDatabase.h"
+#include "LanguageDictionary.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// The pre-buffering row printer (stars style only)
+void legacyDisplayInfo(const Movie& movie) {
+    cout << left << setw(5) << movie.getId()
+         << setw(50) << movie.getName()
+         << setw(6) << movie.getYear()
+         << setw(15) << LanguageDictionary::getName(movie.getLanguageId());
+    cout << "[";
+    int stars = (int)(movie.getRating());
+    for (int i = 0; i < stars; i++) cout << "*";
+    for (int i = stars; i < 10; i++) cout << "-";
+    cout << "] " << fixed << setprecision(1) << movie.getRating() << "/10";
+    cout << endl;
+}
+
+// Milliseconds taken by fn
+template <typename Fn>
+double timeMs(Fn fn) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    fn();
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+
+    const char* languages[] = {"English", "French", "Korean", "Japanese", "Italian", "Spanish", "Portuguese"};
+    MovieDatabase database;
+    database.reserve(count);
+    srand(42);
+    for (int i = 1; i <= count; i++) {
+        database.addMovie(Movie("Movie number " + to_string(i), i, 1900 + rand() % 125,
+                                languages[rand() % 7], (rand() % 91 + 10) / 10.0));
+    }
+
+    double legacy = timeMs([&] {
+        for (int id = 1; id <= count; id++) {
+            legacyDisplayInfo(*database.findMovieById(id));
+        }
+    });
+    double buffered = timeMs([&] { database.displayAllMovies(); });
+
+    cerr << "Rows: " << count << endl;
+    cerr << fixed << setprecision(1);
+    cerr << "  per-field stream + endl : " << legacy << " ms" << endl;
+    cerr << "  displayAllMovies        : " << buffered << " ms  (" << legacy / buffered << "x)" << endl;
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Scaling benchmark for the parallel scan executor.
+//
+// Builds a synthetic catalog and times full-table scans and aggregates
+// with 1, 2, 4, ... up to N threads, checking that every thread count
+// returns exactly the serial result. The query result cache is off for
+// those runs; a last table compares the first run of each query with a
+// repeat answered from the cache.
+//
+// Usage: ScanBenchmark [movies] [maxThreads]
+//        (defaults: 2000000 movies, one thread per core)
+
+#include "MovieDatabase.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Milliseconds per call of fn, averaged over 'repeats' calls
+template <typename Fn>
+double timeMs(int repeats, Fn fn) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        fn();
+    }
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / repeats;
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 2000000;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : static_cast<int>(thread::hardware_concurrency());
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+
+    const char* languages[] = {"English", "French", "Korean", "Japanese", "Italian", "Spanish", "Portuguese"};
+    MovieDatabase database;
+    database.reserve(count);
+    srand(42);
+    for (int i = 1; i <= count; i++) {
+        database.addMovie(Movie("Movie " + to_string(i), i, 1900 + rand() % 125,
+                                languages[rand() % 7], (rand() % 91 + 10) / 10.0));
+    }
+    cout << "Catalog: " << count << " movies, " << ScanKernels::getName() << " kernels" << endl;
+
+    MovieQuery languageQuery = MovieQuery().language("korean");
+    MovieQuery rangeQuery = MovieQuery().ratings(4.0, 6.0).language("french");
+
+    // Serial reference results (uncached: every run below really scans)
+    database.setQueryCacheCapacity(0, 0);
+    database.setScanThreads(1);
+    RatingSummary refSummary = database.getRatingSummary();
+    vector<const Movie*> refLanguage, refRange, refName, rows;
+    database.runQuery(languageQuery, refLanguage);
+    database.runQuery(rangeQuery, refRange);
+    database.findMoviesByName("7", refName);
+
+    double base[4] = {0, 0, 0, 0};
+    cout << left << setw(9) << "Threads" << setw(20) << "rating summary" << setw(20) << "language scan"
+         << setw(20) << "range+language" << setw(20) << "name scan ('7')" << "identical" << endl;
+
+    for (int threads = 1;; threads = threads * 2 < maxThreads ? threads * 2 : maxThreads) {
+        database.setScanThreads(threads);
+        bool same = true;
+        double ms[4];
+        ms[0] = timeMs(20, [&] {
+            RatingSummary s = database.getRatingSummary();
+            same = same && s.sum == refSummary.sum && s.min == refSummary.min && s.max == refSummary.max;
+        });
+        ms[1] = timeMs(10, [&] { database.runQuery(languageQuery, rows); });
+        same = same && rows == refLanguage;
+        ms[2] = timeMs(10, [&] { database.runQuery(rangeQuery, rows); });
+        same = same && rows == refRange;
+        ms[3] = timeMs(5, [&] { database.findMoviesByName("7", rows); });
+        same = same && rows == refName;
+
+        cout << setw(9) << threads;
+        for (int i = 0; i < 4; i++) {
+            if (threads == 1) {
+                base[i] = ms[i];
+            }
+            ostringstream cell;
+            cell << fixed << setprecision(2) << ms[i] << " ms (" << setprecision(1) << base[i] / ms[i] << "x)";
+            cout << setw(20) << cell.str();
+        }
+        cout << (same ? "yes" : "NO") << endl;
+
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+
+    // Repeated queries: the first run scans and fills the cache, repeats
+    // copy the cached slots until the next edit
+    database.setQueryCacheCapacity(QueryCache::DEFAULT_ENTRIES, QueryCache::DEFAULT_ROWS);
+    database.clearQueryCache();
+    cout << endl << left << setw(24) << "Query (" + to_string(maxThreads) + " threads)" << setw(14) << "first run"
+         << setw(14) << "cached" << "identical" << endl;
+    const char* labels[] = {"language scan", "range+language", "name scan ('7')"};
+    for (int q = 0; q < 3; q++) {
+        vector<const Movie*>& reference = q == 0 ? refLanguage : (q == 1 ? refRange : refName);
+        auto run = [&] {
+            if (q == 2) {
+                database.findMoviesByName("7", rows);
+            } else {
+                database.runQuery(q == 0 ? languageQuery : rangeQuery, rows);
+            }
+        };
+        double first = timeMs(1, run);
+        bool same = rows == reference;
+        double cached = timeMs(20, run);
+        same = same && rows == reference;
+        ostringstream firstCell, cachedCell;
+        firstCell << fixed << setprecision(2) << first << " ms";
+        cachedCell << fixed << setprecision(2) << cached << " ms";
+        cout << setw(24) << labels[q] << setw(14) << firstCell.str() << setw(14) << cachedCell.str()
+             << (same ? "yes" : "NO") << endl;
+    }
+    QueryCache::Stats stats = database.getQueryCacheStats();
+    cout << "Cache: " << stats.hits << " hits, " << stats.misses << " misses, " << stats.entries << " entries, "
+         << stats.rows << " rows" << endl;
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include "ScanExecutor.h"
+
+ScanExecutor::ScanExecutor(int threads)
+    : task(nullptr), taskCount(0), nextChunk(0), busyWorkers(0), generation(0), stopping(false),
+      threadCount(1)
+{
+    setThreadCount(threads);
+}
+
+ScanExecutor::~ScanExecutor()
+{
+    stopWorkers();
+}
+
+// Resize the pool; workers are started lazily by the next parallel job
+void ScanExecutor::setThreadCount(int threads)
+{
+    if (threads <= 0)
+    {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+
+    std::lock_guard<std::mutex> guard(runLock);
+    if (threads != threadCount)
+    {
+        stopWorkers();
+        threadCount = threads;
+    }
+}
+
+int ScanExecutor::getThreadCount() const
+{
+    return threadCount;
+}
+
+size_t ScanExecutor::chunkCount(size_t count)
+{
+    return count == 0 ? 0 : (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+}
+
+void ScanExecutor::chunkBounds(size_t count, size_t chunk, size_t &begin, size_t &end)
+{
+    begin = chunk * CHUNK_SIZE;
+    end = begin + CHUNK_SIZE < count ? begin + CHUNK_SIZE : count;
+}
+
+// The caller is one of the threads, so the pool holds threadCount - 1.
+// Workers start out having seen the current generation: it keeps counting
+// across pool restarts, and a fresh worker must not take an old job's
+// bump for a new one.
+void ScanExecutor::startWorkers()
+{
+    unsigned current;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = false;
+        current = generation;
+    }
+    for (int i = 1; i < threadCount; i++)
+    {
+        workers.push_back(std::thread(&ScanExecutor::workerLoop, this, current));
+    }
+}
+
+void ScanExecutor::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+    workers.clear();
+}
+
+void ScanExecutor::workerLoop(unsigned seen)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping)
+            {
+                return;
+            }
+            seen = generation;
+        }
+
+        drain();
+
+        std::lock_guard<std::mutex> guard(lock);
+        if (--busyWorkers == 0)
+        {
+            finished.notify_one();
+        }
+    }
+}
+
+void ScanExecutor::drain()
+{
+    for (size_t chunk = nextChunk++; chunk < taskCount; chunk = nextChunk++)
+    {
+        (*task)(chunk);
+    }
+}
+
+// Hand the chunks to the pool and help out until they are all done
+void ScanExecutor::run(size_t chunks, const std::function<void(size_t)> &job)
+{
+    std::lock_guard<std::mutex> running(runLock);
+    if (threadCount <= 1 || chunks <= 1)
+    {
+        for (size_t chunk = 0; chunk < chunks; chunk++)
+        {
+            job(chunk);
+        }
+        return;
+    }
+
+    if (workers.empty())
+    {
+        startWorkers();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        task = &job;
+        taskCount = chunks;
+        nextChunk = 0;
+        busyWorkers = workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> guard(lock);
+    finished.wait(guard, [&] { return busyWorkers == 0; });
+    task = nullptr;
+}
@@ -0,0 +1,70 @@
+#ifndef SCANEXECUTOR_H
+#define SCANEXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs the chunks of a column scan on a small pool of persistent threads.
+// The movie array is cut into fixed-size chunks regardless of the thread
+// count; idle threads claim the next unprocessed chunk from a shared
+// counter, so a slow chunk never holds up the others. Callers keep one
+// partial result per chunk and merge them in chunk order, which makes the
+// output identical to running the chunks one after another on a single
+// thread.
+class ScanExecutor
+{
+private:
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable wake;     // Workers wait here for a job
+    std::condition_variable finished; // The caller waits here for the workers
+    std::mutex runLock;               // One job at a time
+
+    const std::function<void(size_t)> *task; // Current job
+    size_t taskCount;                         // Chunks in the current job
+    std::atomic<size_t> nextChunk;            // Next chunk nobody has claimed
+    size_t busyWorkers;                       // Workers still inside the job
+    unsigned generation;                      // Bumped for every job
+    bool stopping;
+    int threadCount;
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(unsigned seen); // seen: the generation already handled
+
+    // Claim and run chunks until none are left
+    void drain();
+
+public:
+    // Slots per chunk: large enough to amortize the hand-off, small enough
+    // to balance across cores
+    static const size_t CHUNK_SIZE = 32768;
+
+    // threads <= 0 means one per hardware core
+    explicit ScanExecutor(int threads = 0);
+    ~ScanExecutor();
+
+    ScanExecutor(const ScanExecutor &) = delete;
+    ScanExecutor &operator=(const ScanExecutor &) = delete;
+
+    // Change the number of threads (including the caller) used per job
+    void setThreadCount(int threads);
+    int getThreadCount() const;
+
+    // Number of chunks a scan over 'count' slots is split into
+    static size_t chunkCount(size_t count);
+
+    // Slot range [begin, end) covered by one chunk
+    static void chunkBounds(size_t count, size_t chunk, size_t &begin, size_t &end);
+
+    // Call task(chunk) for every chunk in [0, chunks) and wait for all of
+    // them. Single-chunk jobs and single-thread executors run inline.
+    void run(size_t chunks, const std::function<void(size_t)> &task);
+};
+
+#endif // SCANEXECUTOR_H
@@ -0,0 +1,577 @@
+#include "ScanKernels.h"
+
+// SSE2 is part of the x86-64 baseline; AVX2 is compiled per function and
+// only called after a runtime CPU check (GCC/Clang only)
+#if defined(__x86_64__) || defined(_M_X64)
+#define SCAN_KERNELS_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SCAN_KERNELS_AVX2 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+// Function table for one instruction set
+struct KernelTable
+{
+    const char *name;
+    RatingSummary (*summarizeDouble)(const double *, size_t);
+    YearSummary (*summarizeInt)(const int *, size_t);
+    size_t (*countDouble)(const double *, size_t, double, double);
+    size_t (*countInt)(const int *, size_t, int, int);
+    void (*filterDouble)(const double *, size_t, double, double, std::vector<int> &);
+    void (*filterInt)(const int *, size_t, int, int, std::vector<int> &);
+};
+
+// Number of set bits in a lane mask
+static inline size_t bitCount(unsigned mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcount(mask));
+#else
+    size_t count = 0;
+    while (mask != 0)
+    {
+        mask &= mask - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// Collects the slots of matching lanes in a small buffer and appends them
+// to the result a block at a time. Every lane is written and the end
+// only advances past matches, so the cost does not depend on which lanes
+// matched; a branch per lane mispredicts whenever matches are scattered.
+class MatchBuffer
+{
+private:
+    static const size_t CAPACITY = 256;
+    int buffer[CAPACITY];
+    size_t used;
+    std::vector<int> &slots;
+
+public:
+    explicit MatchBuffer(std::vector<int> &out) : used(0), slots(out) {}
+    ~MatchBuffer() { flush(); }
+
+    MatchBuffer(const MatchBuffer &) = delete;
+    MatchBuffer &operator=(const MatchBuffer &) = delete;
+
+    // Add slot base+b for every set bit b of a lane mask (lanes <= 8)
+    void add(unsigned mask, int lanes, size_t base)
+    {
+        for (int b = 0; b < lanes; b++)
+        {
+            buffer[used] = static_cast<int>(base + b);
+            used += (mask >> b) & 1;
+        }
+        if (used > CAPACITY - 8)
+        {
+            flush();
+        }
+    }
+
+    void flush()
+    {
+        slots.insert(slots.end(), buffer, buffer + used);
+        used = 0;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Scalar kernels (also used for the tails of the vector loops)
+// ---------------------------------------------------------------------------
+
+static void scalarAccumulate(const double *values, size_t begin, size_t end, RatingSummary &s)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        if (values[i] < s.min)
+        {
+            s.min = values[i];
+        }
+        if (values[i] > s.max)
+        {
+            s.max = values[i];
+        }
+        s.sum += values[i];
+    }
+}
+
+static void scalarAccumulate(const int *values, size_t begin, size_t end, YearSummary &s)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        if (values[i] < s.min)
+        {
+            s.min = values[i];
+        }
+        if (values[i] > s.max)
+        {
+            s.max = values[i];
+        }
+        s.sum += values[i];
+    }
+}
+
+// Sums of doubles depend on the order of the additions, so every
+// implementation adds in the AVX2 kernel's order: four lanes taking every
+// fourth value, combined as (0 + 1) + (2 + 3), then the tail one by one
+static RatingSummary scalarSummarizeDouble(const double *values, size_t count)
+{
+    RatingSummary s = {count, 0.0, 0.0, 0.0};
+    if (count == 0)
+    {
+        return s;
+    }
+    s.min = s.max = values[0];
+    size_t i = 0;
+    if (count >= 4)
+    {
+        double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+        for (; i + 4 <= count; i += 4)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                double v = values[i + k];
+                s.min = v < s.min ? v : s.min;
+                s.max = v > s.max ? v : s.max;
+                lanes[k] += v;
+            }
+        }
+        s.sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+    scalarAccumulate(values, i, count, s);
+    return s;
+}
+
+static YearSummary scalarSummarizeInt(const int *values, size_t count)
+{
+    YearSummary s = {count, 0, 0, 0};
+    if (count == 0)
+    {
+        return s;
+    }
+    s.min = s.max = values[0];
+    scalarAccumulate(values, 0, count, s);
+    return s;
+}
+
+template <typename T>
+static size_t scalarCount(const T *values, size_t begin, size_t end, T low, T high)
+{
+    size_t matches = 0;
+    for (size_t i = begin; i < end; i++)
+    {
+        matches += (values[i] >= low && values[i] <= high) ? 1 : 0;
+    }
+    return matches;
+}
+
+template <typename T>
+static void scalarFilter(const T *values, size_t begin, size_t end, T low, T high, std::vector<int> &slots)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        if (values[i] >= low && values[i] <= high)
+        {
+            slots.push_back(static_cast<int>(i));
+        }
+    }
+}
+
+static size_t scalarCountDouble(const double *values, size_t count, double low, double high)
+{
+    return scalarCount(values, 0, count, low, high);
+}
+
+static size_t scalarCountInt(const int *values, size_t count, int low, int high)
+{
+    return scalarCount(values, 0, count, low, high);
+}
+
+static void scalarFilterDouble(const double *values, size_t count, double low, double high, std::vector<int> &slots)
+{
+    scalarFilter(values, 0, count, low, high, slots);
+}
+
+static void scalarFilterInt(const int *values, size_t count, int low, int high, std::vector<int> &slots)
+{
+    scalarFilter(values, 0, count, low, high, slots);
+}
+
+static const KernelTable SCALAR_KERNELS = {
+    "scalar", scalarSummarizeDouble, scalarSummarizeInt, scalarCountDouble,
+    scalarCountInt, scalarFilterDouble, scalarFilterInt};
+
+#if SCAN_KERNELS_SSE2
+// ---------------------------------------------------------------------------
+// SSE2 kernels: 2 doubles or 4 ints per step
+// ---------------------------------------------------------------------------
+
+// Two registers stand in for the AVX2 kernel's four sum lanes
+static RatingSummary sse2SummarizeDouble(const double *values, size_t count)
+{
+    if (count < 4)
+    {
+        return scalarSummarizeDouble(values, count);
+    }
+    __m128d vmin = _mm_loadu_pd(values);
+    __m128d vmax = vmin;
+    __m128d sumLow = _mm_setzero_pd();  // Lanes 0 and 1
+    __m128d sumHigh = _mm_setzero_pd(); // Lanes 2 and 3
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128d low = _mm_loadu_pd(values + i);
+        __m128d high = _mm_loadu_pd(values + i + 2);
+        vmin = _mm_min_pd(vmin, _mm_min_pd(low, high));
+        vmax = _mm_max_pd(vmax, _mm_max_pd(low, high));
+        sumLow = _mm_add_pd(sumLow, low);
+        sumHigh = _mm_add_pd(sumHigh, high);
+    }
+    double lanes[2], upper[2];
+    RatingSummary s = {count, 0.0, 0.0, 0.0};
+    _mm_storeu_pd(lanes, vmin);
+    s.min = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    _mm_storeu_pd(lanes, vmax);
+    s.max = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    _mm_storeu_pd(lanes, sumLow);
+    _mm_storeu_pd(upper, sumHigh);
+    s.sum = (lanes[0] + lanes[1]) + (upper[0] + upper[1]);
+    scalarAccumulate(values, i, count, s);
+    return s;
+}
+
+static YearSummary sse2SummarizeInt(const int *values, size_t count)
+{
+    if (count < 4)
+    {
+        return scalarSummarizeInt(values, count);
+    }
+    __m128i vmin = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    __m128i vmax = vmin;
+    __m128i vsum = _mm_setzero_si128(); // Two 64-bit lanes
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        __m128i lt = _mm_cmplt_epi32(v, vmin);
+        vmin = _mm_or_si128(_mm_and_si128(lt, v), _mm_andnot_si128(lt, vmin));
+        __m128i gt = _mm_cmpgt_epi32(v, vmax);
+        vmax = _mm_or_si128(_mm_and_si128(gt, v), _mm_andnot_si128(gt, vmax));
+        // Sign-extend to 64 bits before adding so large sums can't overflow
+        __m128i sign = _mm_cmplt_epi32(v, _mm_setzero_si128());
+        vsum = _mm_add_epi64(vsum, _mm_unpacklo_epi32(v, sign));
+        vsum = _mm_add_epi64(vsum, _mm_unpackhi_epi32(v, sign));
+    }
+    int lanes[4];
+    int64_t sums[2];
+    YearSummary s = {count, 0, 0, 0};
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vmin);
+    s.min = lanes[0];
+    for (int k = 1; k < 4; k++)
+    {
+        s.min = lanes[k] < s.min ? lanes[k] : s.min;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vmax);
+    s.max = lanes[0];
+    for (int k = 1; k < 4; k++)
+    {
+        s.max = lanes[k] > s.max ? lanes[k] : s.max;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(sums), vsum);
+    s.sum = sums[0] + sums[1];
+    scalarAccumulate(values, i, count, s);
+    return s;
+}
+
+static inline unsigned sse2RangeMask(__m128d v, __m128d low, __m128d high)
+{
+    return static_cast<unsigned>(_mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(v, low), _mm_cmple_pd(v, high))));
+}
+
+static inline unsigned sse2RangeMask(__m128i v, __m128i low, __m128i high)
+{
+    __m128i outside = _mm_or_si128(_mm_cmplt_epi32(v, low), _mm_cmpgt_epi32(v, high));
+    return static_cast<unsigned>(~_mm_movemask_ps(_mm_castsi128_ps(outside))) & 0xfu;
+}
+
+static size_t sse2CountDouble(const double *values, size_t count, double low, double high)
+{
+    __m128d vlow = _mm_set1_pd(low), vhigh = _mm_set1_pd(high);
+    size_t matches = 0, i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        matches += bitCount(sse2RangeMask(_mm_loadu_pd(values + i), vlow, vhigh));
+    }
+    return matches + scalarCount(values, i, count, low, high);
+}
+
+static size_t sse2CountInt(const int *values, size_t count, int low, int high)
+{
+    __m128i vlow = _mm_set1_epi32(low), vhigh = _mm_set1_epi32(high);
+    size_t matches = 0, i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        matches += bitCount(sse2RangeMask(v, vlow, vhigh));
+    }
+    return matches + scalarCount(values, i, count, low, high);
+}
+
+static void sse2FilterDouble(const double *values, size_t count, double low, double high, std::vector<int> &slots)
+{
+    __m128d vlow = _mm_set1_pd(low), vhigh = _mm_set1_pd(high);
+    size_t i = 0;
+    {
+        MatchBuffer matches(slots);
+        for (; i + 2 <= count; i += 2)
+        {
+            matches.add(sse2RangeMask(_mm_loadu_pd(values + i), vlow, vhigh), 2, i);
+        }
+    }
+    scalarFilter(values, i, count, low, high, slots);
+}
+
+static void sse2FilterInt(const int *values, size_t count, int low, int high, std::vector<int> &slots)
+{
+    __m128i vlow = _mm_set1_epi32(low), vhigh = _mm_set1_epi32(high);
+    size_t i = 0;
+    {
+        MatchBuffer matches(slots);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+            matches.add(sse2RangeMask(v, vlow, vhigh), 4, i);
+        }
+    }
+    scalarFilter(values, i, count, low, high, slots);
+}
+
+static const KernelTable SSE2_KERNELS = {
+    "sse2", sse2SummarizeDouble, sse2SummarizeInt, sse2CountDouble,
+    sse2CountInt, sse2FilterDouble, sse2FilterInt};
+#endif // SCAN_KERNELS_SSE2
+
+#if SCAN_KERNELS_AVX2
+// ---------------------------------------------------------------------------
+// AVX2 kernels: 4 doubles or 8 ints per step
+// ---------------------------------------------------------------------------
+
+AVX2_TARGET static RatingSummary avx2SummarizeDouble(const double *values, size_t count)
+{
+    if (count < 4)
+    {
+        return scalarSummarizeDouble(values, count);
+    }
+    __m256d vmin = _mm256_loadu_pd(values);
+    __m256d vmax = vmin;
+    __m256d vsum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d v = _mm256_loadu_pd(values + i);
+        vmin = _mm256_min_pd(vmin, v);
+        vmax = _mm256_max_pd(vmax, v);
+        vsum = _mm256_add_pd(vsum, v);
+    }
+    double lanes[4];
+    RatingSummary s = {count, 0.0, 0.0, 0.0};
+    _mm256_storeu_pd(lanes, vmin);
+    s.min = lanes[0];
+    for (int k = 1; k < 4; k++)
+    {
+        s.min = lanes[k] < s.min ? lanes[k] : s.min;
+    }
+    _mm256_storeu_pd(lanes, vmax);
+    s.max = lanes[0];
+    for (int k = 1; k < 4; k++)
+    {
+        s.max = lanes[k] > s.max ? lanes[k] : s.max;
+    }
+    _mm256_storeu_pd(lanes, vsum);
+    s.sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    scalarAccumulate(values, i, count, s);
+    return s;
+}
+
+AVX2_TARGET static YearSummary avx2SummarizeInt(const int *values, size_t count)
+{
+    if (count < 8)
+    {
+        return scalarSummarizeInt(values, count);
+    }
+    __m256i vmin = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    __m256i vmax = vmin;
+    __m256i vsum = _mm256_setzero_si256(); // Four 64-bit lanes
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        vmin = _mm256_min_epi32(vmin, v);
+        vmax = _mm256_max_epi32(vmax, v);
+        vsum = _mm256_add_epi64(vsum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        vsum = _mm256_add_epi64(vsum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    int lanes[8];
+    int64_t sums[4];
+    YearSummary s = {count, 0, 0, 0};
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), vmin);
+    s.min = lanes[0];
+    for (int k = 1; k < 8; k++)
+    {
+        s.min = lanes[k] < s.min ? lanes[k] : s.min;
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), vmax);
+    s.max = lanes[0];
+    for (int k = 1; k < 8; k++)
+    {
+        s.max = lanes[k] > s.max ? lanes[k] : s.max;
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums), vsum);
+    s.sum = sums[0] + sums[1] + sums[2] + sums[3];
+    scalarAccumulate(values, i, count, s);
+    return s;
+}
+
+AVX2_TARGET static inline unsigned avx2RangeMask(__m256d v, __m256d low, __m256d high)
+{
+    __m256d inside = _mm256_and_pd(_mm256_cmp_pd(v, low, _CMP_GE_OQ), _mm256_cmp_pd(v, high, _CMP_LE_OQ));
+    return static_cast<unsigned>(_mm256_movemask_pd(inside));
+}
+
+AVX2_TARGET static inline unsigned avx2RangeMask(__m256i v, __m256i low, __m256i high)
+{
+    __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(low, v), _mm256_cmpgt_epi32(v, high));
+    return static_cast<unsigned>(~_mm256_movemask_ps(_mm256_castsi256_ps(outside))) & 0xffu;
+}
+
+AVX2_TARGET static size_t avx2CountDouble(const double *values, size_t count, double low, double high)
+{
+    __m256d vlow = _mm256_set1_pd(low), vhigh = _mm256_set1_pd(high);
+    size_t matches = 0, i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        matches += bitCount(avx2RangeMask(_mm256_loadu_pd(values + i), vlow, vhigh));
+    }
+    return matches + scalarCount(values, i, count, low, high);
+}
+
+AVX2_TARGET static size_t avx2CountInt(const int *values, size_t count, int low, int high)
+{
+    __m256i vlow = _mm256_set1_epi32(low), vhigh = _mm256_set1_epi32(high);
+    size_t matches = 0, i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        matches += bitCount(avx2RangeMask(v, vlow, vhigh));
+    }
+    return matches + scalarCount(values, i, count, low, high);
+}
+
+AVX2_TARGET static void avx2FilterDouble(const double *values, size_t count, double low, double high, std::vector<int> &slots)
+{
+    __m256d vlow = _mm256_set1_pd(low), vhigh = _mm256_set1_pd(high);
+    size_t i = 0;
+    {
+        MatchBuffer matches(slots);
+        for (; i + 4 <= count; i += 4)
+        {
+            matches.add(avx2RangeMask(_mm256_loadu_pd(values + i), vlow, vhigh), 4, i);
+        }
+    }
+    scalarFilter(values, i, count, low, high, slots);
+}
+
+AVX2_TARGET static void avx2FilterInt(const int *values, size_t count, int low, int high, std::vector<int> &slots)
+{
+    __m256i vlow = _mm256_set1_epi32(low), vhigh = _mm256_set1_epi32(high);
+    size_t i = 0;
+    {
+        MatchBuffer matches(slots);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+            matches.add(avx2RangeMask(v, vlow, vhigh), 8, i);
+        }
+    }
+    scalarFilter(values, i, count, low, high, slots);
+}
+
+static const KernelTable AVX2_KERNELS = {
+    "avx2", avx2SummarizeDouble, avx2SummarizeInt, avx2CountDouble,
+    avx2CountInt, avx2FilterDouble, avx2FilterInt};
+#endif // SCAN_KERNELS_AVX2
+
+// ---------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------
+
+// Best table the running CPU can execute
+static const KernelTable *detectKernels()
+{
+#if SCAN_KERNELS_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return &AVX2_KERNELS;
+    }
+#endif
+#if SCAN_KERNELS_SSE2
+    return &SSE2_KERNELS;
+#else
+    return &SCALAR_KERNELS;
+#endif
+}
+
+// Selected on first use; useScalar() is meant to be called before scans start
+static const KernelTable *&activeKernels()
+{
+    static const KernelTable *active = detectKernels();
+    return active;
+}
+
+const char *ScanKernels::getName()
+{
+    return activeKernels()->name;
+}
+
+void ScanKernels::useScalar(bool scalarOnly)
+{
+    activeKernels() = scalarOnly ? &SCALAR_KERNELS : detectKernels();
+}
+
+RatingSummary ScanKernels::summarize(const double *values, size_t count)
+{
+    return activeKernels()->summarizeDouble(values, count);
+}
+
+YearSummary ScanKernels::summarize(const int *values, size_t count)
+{
+    return activeKernels()->summarizeInt(values, count);
+}
+
+size_t ScanKernels::countInRange(const double *values, size_t count, double low, double high)
+{
+    return activeKernels()->countDouble(values, count, low, high);
+}
+
+size_t ScanKernels::countInRange(const int *values, size_t count, int low, int high)
+{
+    return activeKernels()->countInt(values, count, low, high);
+}
+
+void ScanKernels::filterInRange(const double *values, size_t count, double low, double high,
+                                std::vector<int> &slots)
+{
+    activeKernels()->filterDouble(values, count, low, high, slots);
+}
+
+void ScanKernels::filterInRange(const int *values, size_t count, int low, int high,
+                                std::vector<int> &slots)
+{
+    activeKernels()->filterInt(values, count, low, high, slots);
+}
@@ -0,0 +1,53 @@
+#ifndef SCANKERNELS_H
+#define SCANKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Aggregate over a column of ratings
+struct RatingSummary
+{
+    size_t count;
+    double min;
+    double max;
+    double sum;
+};
+
+// Aggregate over a column of years
+struct YearSummary
+{
+    size_t count;
+    int min;
+    int max;
+    int64_t sum;
+};
+
+// Vectorized aggregate and filter kernels over MovieColumns arrays. The
+// widest instruction set the CPU supports (AVX2, then SSE2, then plain C++)
+// is picked once at startup; every variant returns the same results.
+class ScanKernels
+{
+public:
+    // Name of the selected implementation ("avx2", "sse2" or "scalar")
+    static const char *getName();
+
+    // Force the portable implementation (for comparisons and debugging)
+    static void useScalar(bool scalarOnly);
+
+    // min/max/sum/count in one pass; min/max are 0 for an empty column
+    static RatingSummary summarize(const double *values, size_t count);
+    static YearSummary summarize(const int *values, size_t count);
+
+    // Number of values with low <= v <= high
+    static size_t countInRange(const double *values, size_t count, double low, double high);
+    static size_t countInRange(const int *values, size_t count, int low, int high);
+
+    // Append the index of every value with low <= v <= high, in order
+    static void filterInRange(const double *values, size_t count, double low, double high,
+                              std::vector<int> &slots);
+    static void filterInRange(const int *values, size_t count, int low, int high,
+                              std::vector<int> &slots);
+};
+
+#endif // SCANKERNELS_H
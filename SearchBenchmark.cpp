@@ -0,0 +1,166 @@
+// Benchmark for typo-tolerant name search.
+//
+// Builds a synthetic catalog whose titles are made of words drawn from a
+// skewed vocabulary (a few very common words, a long tail of rare ones),
+// then times findSimilarNames for misspelled words and phrases taken from
+// real titles. A sample of the queries is also answered by brute force
+// (edit distance against every title) to check that the indexed search
+// returns the same closest distance and to show what the index saves.
+//
+// Usage: SearchBenchmark [movies] [queries]
+//        (defaults: 1000000 movies, 200 queries)
+
+#include "MovieDatabase.h"
+#include "FuzzyMatcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Milliseconds taken by one call of fn
+template <typename Fn>
+double timeMs(Fn fn) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    fn();
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// A pronounceable made-up word of two to four syllables
+string makeWord() {
+    static const char* onsets[] = {"b", "c", "d", "f", "g", "h", "k", "l", "m", "n", "p", "r", "s", "t", "v",
+                                   "w", "br", "ch", "dr", "gr", "sh", "st", "th", "tr"};
+    static const char* vowels[] = {"a", "e", "i", "o", "u", "ai", "ea", "ou"};
+    static const char* codas[] = {"", "", "", "n", "r", "s", "t", "nk", "ll", "rd"};
+    string word;
+    int syllables = 2 + rand() % 3;
+    for (int s = 0; s < syllables; s++) {
+        word += onsets[rand() % 24];
+        word += vowels[rand() % 8];
+        word += codas[rand() % 10];
+    }
+    return word;
+}
+
+// Replace, drop or insert one letter
+void addTypo(string& text) {
+    size_t at = rand() % text.size();
+    char letter = static_cast<char>('a' + rand() % 26);
+    switch (rand() % 3) {
+        case 0: text[at] = letter; break;
+        case 1: if (text.size() > 4) text.erase(at, 1); break;
+        default: text.insert(at, 1, letter); break;
+    }
+}
+
+string formatMs(double ms) {
+    ostringstream cell;
+    cell << fixed << setprecision(3) << ms << " ms";
+    return cell.str();
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    int queries = argc > 2 ? atoi(argv[2]) : 200;
+
+    // Vocabulary: common short words first, then 50000 made-up ones;
+    // picking with a squared random index favours the front of the list
+    const char* common[] = {"the", "of", "and", "a", "in", "night", "love", "man", "last", "dark", "city",
+                            "king", "return", "story", "life", "day", "world", "war", "girl", "house"};
+    vector<string> words(common, common + 20);
+    for (int i = 0; i < 50000; i++) {
+        words.push_back(makeWord());
+    }
+
+    MovieDatabase database;
+    database.setStorageMode(MovieDatabase::STORAGE_POOLED);
+    database.reserve(count);
+    srand(7);
+    for (int i = 1; i <= count; i++) {
+        string name;
+        int length = 1 + rand() % 5;
+        for (int w = 0; w < length; w++) {
+            double r = static_cast<double>(rand()) / RAND_MAX;
+            name += (w ? " " : "") + words[static_cast<size_t>(r * r * (words.size() - 1))];
+        }
+        name[0] = static_cast<char>(toupper(name[0]));
+        database.emplaceMovie(name, i, 1900 + rand() % 125, "English", (rand() % 91 + 10) / 10.0);
+    }
+    cout << "Catalog: " << count << " movies" << endl;
+
+    // Queries: one or two consecutive words of a random title, with one or
+    // two typos
+    vector<const Movie*> all;
+    database.runQuery(MovieQuery(), all);
+    vector<string> terms;
+    vector<int> typos;
+    for (int q = 0; q < queries; q++) {
+        string name = Movie::foldCase(all[rand() % all.size()]->getName());
+        size_t start = name.rfind(' ', rand() % name.size());
+        start = start == string::npos ? 0 : start + 1;
+        size_t end = name.find(' ', start);
+        if (rand() % 2 && end != string::npos) {
+            end = name.find(' ', end + 1);
+        }
+        string term = name.substr(start, end == string::npos ? string::npos : end - start);
+        int edits = term.size() >= 8 ? 1 + rand() % 2 : 1;
+        for (int e = 0; e < edits; e++) {
+            addTypo(term);
+        }
+        terms.push_back(term);
+        typos.push_back(edits);
+    }
+
+    database.setQueryCacheCapacity(0, 0);
+    vector<double> times;
+    vector<TitleMatch> matches;
+    vector<const Movie*> exact;
+    size_t found = 0;
+    double exactTotal = 0;
+    for (size_t q = 0; q < terms.size(); q++) {
+        exactTotal += timeMs([&] { database.findMoviesByName(terms[q], exact); });
+        times.push_back(timeMs([&] { database.findSimilarNames(terms[q], 10, matches); }));
+        found += !matches.empty() && matches[0].distance <= typos[q];
+    }
+    sort(times.begin(), times.end());
+    double total = 0;
+    for (size_t i = 0; i < times.size(); i++) {
+        total += times[i];
+    }
+
+    cout << endl << left << setw(36) << "Search (" + to_string(terms.size()) + " misspelled terms)" << setw(14)
+         << "mean" << setw(14) << "median" << "slowest" << endl;
+    cout << setw(36) << "exact substring (findMoviesByName)" << setw(14) << formatMs(exactTotal / terms.size())
+         << endl;
+    cout << setw(36) << "fuzzy top 10 (findSimilarNames)" << setw(14) << formatMs(total / times.size()) << setw(14)
+         << formatMs(times[times.size() / 2]) << formatMs(times.back()) << endl;
+    cout << "Terms with a match within their typo count: " << found << " of " << terms.size() << endl;
+
+    // Brute force on a sample: edit distance against every title
+    size_t sample = min<size_t>(terms.size(), 10);
+    double bruteTotal = 0;
+    bool same = true;
+    for (size_t q = 0; q < sample; q++) {
+        string term = Movie::foldCase(terms[q]);
+        FuzzyMatcher matcher(term);
+        int limit = FuzzyMatcher::defaultLimit(term.size());
+        int best = limit + 1;
+        bruteTotal += timeMs([&] {
+            for (size_t i = 0; i < all.size(); i++) {
+                best = min(best, matcher.distanceIn(all[i]->getFoldedName(), limit));
+            }
+        });
+        database.findSimilarNames(terms[q], 10, matches);
+        same = same && (matches.empty() ? best > limit : matches[0].distance == best);
+    }
+    cout << setw(36) << "brute force (every title)" << setw(14) << formatMs(bruteTotal / sample) << endl;
+    cout << "Closest distance identical to brute force: " << (same ? "yes" : "NO") << " (" << sample
+         << " terms)" << endl;
+    return 0;
+}
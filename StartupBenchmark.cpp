@@ -0,0 +1,130 @@
+// Benchmark for database construction and startup memory.
+//
+// The database used to allocate a fixed array of 100,000 default-constructed
+// movies up front; storage now grows with the catalog and can be reserved
+// from a known count (loadFromFile reserves from the file header). This
+// reports time, heap allocations and heap bytes held for:
+//   - the old fixed array on its own, as a reference for the old startup
+//     cost (built from today's 40-byte Movie, so it understates the
+//     original, whose movies each held two std::strings)
+//   - an empty database
+//   - a full catalog added one movie at a time, with and without reserve()
+//   - the same catalog loaded from a saved file
+// Heap use is counted through a replacement operator new, as in
+// StorageBenchmark, so the numbers are the same on every platform.
+//
+// Usage: StartupBenchmark [movies] [file]
+//        (defaults: 100000 movies, startup_bench.dat)
+
+#include "MovieDatabase.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace std;
+
+// Heap accounting: every block carries its size in front of it
+static size_t liveBytes = 0;
+static size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    liveBytes += size;
+    size_t* block = static_cast<size_t*>(malloc(size + sizeof(max_align_t)));
+    if (!block) throw bad_alloc();
+    *block = size;
+    return reinterpret_cast<char*>(block) + sizeof(max_align_t);
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    size_t* block = reinterpret_cast<size_t*>(static_cast<char*>(pointer) - sizeof(max_align_t));
+    liveBytes -= *block;
+    free(block);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { operator delete(pointer); }
+
+// Time, allocations and bytes still held after one setup step
+struct Measurement {
+    double ms;
+    size_t allocations;
+    size_t bytes;
+};
+
+template <typename Fn>
+Measurement measure(Fn fn) {
+    size_t bytesBefore = liveBytes;
+    size_t allocationsBefore = allocationCount;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    fn();
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    Measurement result = {elapsed.count(), allocationCount - allocationsBefore, liveBytes - bytesBefore};
+    return result;
+}
+
+void report(const string& label, const Measurement& m) {
+    cout << "  " << left << setw(40) << label << right << fixed << setprecision(2) << setw(9) << m.ms << " ms"
+         << setw(10) << m.allocations << " allocations" << setw(10) << setprecision(0)
+         << m.bytes / 1024.0 << " KB held" << endl;
+}
+
+void fill(MovieDatabase& database, int count) {
+    const char* languages[] = {"English", "French", "Korean", "Japanese", "Italian"};
+    srand(3);
+    for (int id = 1; id <= count; id++) {
+        database.emplaceMovie("The Remarkable Movie Number " + to_string(id), id, 1900 + rand() % 125,
+                              languages[rand() % 5], (rand() % 91 + 10) / 10.0);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    string filename = argc > 2 ? argv[2] : "startup_bench.dat";
+
+    {
+        MovieDatabase database;
+        fill(database, count);
+        database.saveToFile(filename);
+    }
+
+    cout << "Startup cost (sizeof(Movie) = " << sizeof(Movie) << " bytes)" << endl;
+
+    Movie* oldArray = nullptr;
+    report("old fixed array: new Movie[100000]", measure([&] { oldArray = new Movie[100000]; }));
+    delete[] oldArray;
+
+    MovieDatabase* database = nullptr;
+    report("empty database", measure([&] { database = new MovieDatabase(); }));
+    delete database;
+
+    cout << "Full catalog (" << count << " movies)" << endl;
+    report("added one by one", measure([&] {
+               database = new MovieDatabase();
+               fill(*database, count);
+           }));
+    delete database;
+
+    report("added after reserve(" + to_string(count) + ")", measure([&] {
+               database = new MovieDatabase();
+               database->reserve(count);
+               fill(*database, count);
+           }));
+    delete database;
+
+    report("loaded from file (reserves from header)", measure([&] {
+               database = new MovieDatabase();
+               database->loadFromFile(filename);
+           }));
+    delete database;
+
+    remove(filename.c_str());
+    return 0;
+}
@@ -0,0 +1,175 @@
+// Benchmark for movie name storage.
+//
+// Saves a synthetic catalog, then loads it once per storage mode
+// (STORAGE_OWNED: one heap block per movie name, STORAGE_POOLED: names
+// packed into a StringPool) and reports load time, heap allocations made
+// by the load, and the heap bytes the loaded database holds. Heap use is
+// counted through a replacement operator new, so it is the same on every
+// platform; it excludes the allocator's own per-block overhead, which
+// makes the allocation count the better guide to fragmentation.
+//
+// Then it counts the allocations made by common loops over the loaded
+// catalog (accessors, name search, save, export, and adding movies by copy
+// versus in place), reported per movie.
+//
+// Usage: StorageBenchmark [movies] [file]
+//        (default: 1000000 movies, storage_bench.dat)
+
+#include "MovieDatabase.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Heap accounting: every block carries its size in front of it
+static size_t liveBytes = 0;
+static size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    liveBytes += size;
+    size_t* block = static_cast<size_t*>(malloc(size + sizeof(max_align_t)));
+    if (!block) throw bad_alloc();
+    *block = size;
+    return reinterpret_cast<char*>(block) + sizeof(max_align_t);
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    size_t* block = reinterpret_cast<size_t*>(static_cast<char*>(pointer) - sizeof(max_align_t));
+    liveBytes -= *block;
+    free(block);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { operator delete(pointer); }
+
+// Print the allocations one loop made, in total and per movie
+static void reportLoop(const char* label, size_t allocations, int movies) {
+    cout << "  " << left << setw(34) << label << right << setw(9) << allocations << " allocations   "
+         << fixed << setprecision(2) << setw(6) << static_cast<double>(allocations) / movies << " per movie" << endl;
+}
+
+// An output stream that discards everything
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) { return c; }
+    streamsize xsputn(const char*, streamsize count) { return count; }
+};
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    string filename = argc > 2 ? argv[2] : "storage_bench.dat";
+
+    {
+        const char* languages[] = {"English", "French", "Korean", "Japanese", "Italian", "Spanish", "Portuguese"};
+        MovieDatabase database;
+        database.reserve(count);
+        srand(42);
+        for (int i = 1; i <= count; i++) {
+            database.addMovie(Movie("The Remarkable Movie Number " + to_string(i), i, 1900 + rand() % 125,
+                                    languages[rand() % 7], (rand() % 91 + 10) / 10.0));
+        }
+        database.saveToFile(filename);
+    }
+
+    cout << "Movies: " << count << "  (sizeof(Movie) = " << sizeof(Movie) << " bytes)" << endl;
+    const char* labels[] = {"owned (heap per name)", "pooled (StringPool)"};
+    MovieDatabase::StorageMode modes[] = {MovieDatabase::STORAGE_OWNED, MovieDatabase::STORAGE_POOLED};
+    for (int m = 0; m < 2; m++) {
+        size_t bytesBefore = liveBytes;
+        size_t allocationsBefore = allocationCount;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        MovieDatabase* database = new MovieDatabase();
+        database->setStorageMode(modes[m]);
+        database->loadFromFile(filename);
+
+        chrono::duration<double, milli> loadTime = chrono::steady_clock::now() - start;
+        size_t held = liveBytes - bytesBefore;
+        size_t allocations = allocationCount - allocationsBefore;
+
+        start = chrono::steady_clock::now();
+        delete database;
+        chrono::duration<double, milli> freeTime = chrono::steady_clock::now() - start;
+
+        cout << "  " << left << setw(24) << labels[m] << right << fixed << setprecision(0)
+             << "load " << setw(6) << loadTime.count() << " ms   "
+             << setw(9) << allocations << " allocations   "
+             << setw(5) << held / (1024 * 1024) << " MB held   "
+             << "free " << setw(5) << freeTime.count() << " ms" << endl;
+    }
+
+    // Allocations made inside loops over a loaded (pooled) catalog
+    cout << "Hot loops over " << count << " movies:" << endl;
+    {
+        MovieDatabase database;
+        database.setStorageMode(MovieDatabase::STORAGE_POOLED);
+        database.loadFromFile(filename);
+        vector<const Movie*> all;
+        database.runQuery(MovieQuery(), all);
+
+        size_t before = allocationCount;
+        size_t total = 0;
+        for (size_t i = 0; i < all.size(); i++) {
+            total += all[i]->getName().size() + all[i]->getLanguage().size();
+        }
+        reportLoop("getName() copies", allocationCount - before, count);
+
+        before = allocationCount;
+        for (size_t i = 0; i < all.size(); i++) {
+            total += all[i]->getNameView().size() + all[i]->getFoldedName().size() + all[i]->getLanguage().size();
+        }
+        reportLoop("getNameView/getLanguage refs", allocationCount - before, count);
+
+        vector<const Movie*> results;
+        results.reserve(all.size());
+        before = allocationCount;
+        database.findMoviesByName("number 42", results, false);
+        total += results.size();
+        reportLoop("findMoviesByName", allocationCount - before, count);
+
+        before = allocationCount;
+        database.saveToFile(filename + ".copy");
+        reportLoop("saveToFile", allocationCount - before, count);
+        remove((filename + ".copy").c_str());
+
+        NullBuffer discard;
+        ostream sink(&discard);
+        before = allocationCount;
+        database.exportMovies(sink, MovieExporter::FORMAT_JSON_LINES);
+        reportLoop("exportMovies (JSON Lines)", allocationCount - before, count);
+
+        // Adding: the copy overload allocates a temporary owned movie first
+        MovieDatabase copied, emplaced;
+        copied.setStorageMode(MovieDatabase::STORAGE_POOLED);
+        emplaced.setStorageMode(MovieDatabase::STORAGE_POOLED);
+        copied.reserve(count);
+        emplaced.reserve(count);
+        before = allocationCount;
+        for (size_t i = 0; i < all.size(); i++) {
+            const Movie& m = *all[i];
+            copied.addMovie(Movie(m.getNameView(), m.getId(), m.getYear(), m.getLanguage(), m.getRating()));
+        }
+        reportLoop("addMovie(Movie(...)) (indexes too)", allocationCount - before, count);
+        before = allocationCount;
+        for (size_t i = 0; i < all.size(); i++) {
+            const Movie& m = *all[i];
+            emplaced.emplaceMovie(m.getNameView(), m.getId(), m.getYear(), m.getLanguage(), m.getRating());
+        }
+        reportLoop("emplaceMovie (indexes too)", allocationCount - before, count);
+        if (total == 0) cout << endl; // Keep the loops from being optimized away
+    }
+
+    remove(filename.c_str());
+    return 0;
+}
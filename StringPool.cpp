@@ -0,0 +1,70 @@
+#include "StringPool.h"
+#include <utility>
+
+StringPool::StringPool() : blockUsed(0), blockSize(0), usedBytes(0), reservedBytes(0)
+{
+}
+
+StringPool::~StringPool()
+{
+    clear();
+}
+
+// Bump-allocate from the current block, starting a new one when it is full
+char *StringPool::allocate(size_t size)
+{
+    if (blocks.empty() || blockSize - blockUsed < size)
+    {
+        size_t newSize = size > BLOCK_BYTES ? size : BLOCK_BYTES;
+        if (!blocks.empty() && newSize > BLOCK_BYTES)
+        {
+            // Oversized string: give it its own block behind the current
+            // one, so the rest of the current block can still be used
+            char *own = new char[newSize];
+            blocks.insert(blocks.end() - 1, own);
+            reservedBytes += newSize;
+            usedBytes += size;
+            return own;
+        }
+        blocks.push_back(new char[newSize]);
+        blockSize = newSize;
+        blockUsed = 0;
+        reservedBytes += newSize;
+    }
+    char *result = blocks.back() + blockUsed;
+    blockUsed += size;
+    usedBytes += size;
+    return result;
+}
+
+void StringPool::clear()
+{
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        delete[] blocks[i];
+    }
+    blocks.clear();
+    blockUsed = 0;
+    blockSize = 0;
+    usedBytes = 0;
+    reservedBytes = 0;
+}
+
+void StringPool::swap(StringPool &other)
+{
+    blocks.swap(other.blocks);
+    std::swap(blockUsed, other.blockUsed);
+    std::swap(blockSize, other.blockSize);
+    std::swap(usedBytes, other.usedBytes);
+    std::swap(reservedBytes, other.reservedBytes);
+}
+
+size_t StringPool::getUsedBytes() const
+{
+    return usedBytes;
+}
+
+size_t StringPool::getReservedBytes() const
+{
+    return reservedBytes;
+}
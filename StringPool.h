@@ -0,0 +1,88 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Read-only view of characters stored elsewhere: a stand-in for C++17's
+// std::string_view. Cheap to copy; valid only while the storage it points
+// into is.
+class TextView
+{
+private:
+    const char *start;
+    size_t length;
+
+public:
+    TextView() : start(""), length(0) {}
+    TextView(const char *data, size_t size) : start(data), length(size) {}
+    TextView(const std::string &text) : start(text.data()), length(text.size()) {}
+    TextView(const char *text) : start(text), length(std::strlen(text)) {}
+
+    const char *data() const { return start; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    char operator[](size_t i) const { return start[i]; }
+
+    // Byte-wise ordering like std::string::compare
+    int compare(const TextView &other) const
+    {
+        size_t common = length < other.length ? length : other.length;
+        int result = common == 0 ? 0 : std::memcmp(start, other.start, common);
+        if (result != 0)
+        {
+            return result;
+        }
+        return length < other.length ? -1 : (length > other.length ? 1 : 0);
+    }
+
+    bool operator==(const TextView &other) const
+    {
+        return length == other.length && (length == 0 || std::memcmp(start, other.start, length) == 0);
+    }
+    bool operator!=(const TextView &other) const { return !(*this == other); }
+
+    // Owning copy
+    std::string str() const { return std::string(start, length); }
+};
+
+// Append-only arena for many small strings. Text is copied into large
+// blocks and never moves afterwards, so a pointer into the pool stays
+// valid until clear(). Storing a string is a bump of an offset instead of
+// a malloc, and a million titles end up in a few dozen blocks instead of
+// a million separate heap chunks.
+class StringPool
+{
+private:
+    std::vector<char *> blocks; // Every block, the current one last
+    size_t blockUsed;           // Bytes taken in the current block
+    size_t blockSize;           // Size of the current block
+    size_t usedBytes;           // Bytes handed out since the last clear
+    size_t reservedBytes;       // Bytes allocated for blocks
+
+public:
+    // Size of a regular block; longer strings get a block of their own
+    static const size_t BLOCK_BYTES = 1024 * 1024;
+
+    StringPool();
+    ~StringPool();
+
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    // Room for 'size' bytes that stays put until clear()
+    char *allocate(size_t size);
+
+    // Free every block at once
+    void clear();
+
+    // Exchange contents with another pool
+    void swap(StringPool &other);
+
+    // Bytes handed out / bytes held in blocks
+    size_t getUsedBytes() const;
+    size_t getReservedBytes() const;
+};
+
+#endif // STRINGPOOL_H
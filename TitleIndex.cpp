@@ -0,0 +1,462 @@
+#include "TitleIndex.h"
+#include <algorithm>
+#include <iterator>
+#include <cctype>
+
+// Pack three case-folded bytes into one key
+static uint32_t packTrigram(TextView text, size_t i)
+{
+    return (static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(text[i]))) << 16) |
+           (static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(text[i + 1]))) << 8) |
+           static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(text[i + 2])));
+}
+
+// True if two ascending lists have an element in common
+static bool sharesAny(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b)
+{
+    for (size_t i = 0, j = 0; i < a.size() && j < b.size();)
+    {
+        if (a[i] == b[j])
+        {
+            return true;
+        }
+        a[i] < b[j] ? i++ : j++;
+    }
+    return false;
+}
+
+// Collect each trigram of a string once
+void TitleIndex::trigramsOf(TextView text, std::vector<uint32_t> &out)
+{
+    out.clear();
+    if (text.size() < MIN_QUERY_LENGTH)
+    {
+        return;
+    }
+    out.reserve(text.size() - 2);
+    for (size_t i = 0; i + 2 < text.size(); i++)
+    {
+        out.push_back(packTrigram(text, i));
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+TitleIndex::TitleIndex() : staleCount(0), entryCount(0)
+{
+}
+
+// Insert an ID into each of the title's posting lists (kept sorted). An
+// entry still waiting to be purged is simply brought back to life.
+void TitleIndex::add(int id, TextView name)
+{
+    std::vector<uint32_t> &grams = scratch;
+    trigramsOf(name, grams);
+    if (!stale.empty())
+    {
+        revive(id, grams);
+    }
+    for (size_t i = 0; i < grams.size(); i++)
+    {
+        std::vector<int> &list = postings[grams[i]];
+        if (list.empty() || list.back() < id)
+        {
+            list.push_back(id); // Common case: IDs arrive in increasing order
+            entryCount++;
+        }
+        else
+        {
+            std::vector<int>::iterator it = std::lower_bound(list.begin(), list.end(), id);
+            if (it == list.end() || *it != id)
+            {
+                list.insert(it, id);
+                entryCount++;
+            }
+        }
+    }
+}
+
+// Erasing from the middle of a posting list costs its length, which for
+// trigrams common to many titles is most of the catalog. Removal only
+// records the title's trigrams as stale instead; lookups skip those
+// entries, and they are purged in bulk once they make up an eighth of the
+// index.
+void TitleIndex::remove(int id, TextView name)
+{
+    std::vector<uint32_t> &grams = scratch;
+    trigramsOf(name, grams);
+    if (grams.empty())
+    {
+        return;
+    }
+    std::vector<uint32_t> &removed = stale[id];
+    size_t before = removed.size();
+    if (removed.empty())
+    {
+        removed = grams;
+    }
+    else
+    {
+        std::vector<uint32_t> merged;
+        std::set_union(removed.begin(), removed.end(), grams.begin(), grams.end(), std::back_inserter(merged));
+        removed.swap(merged);
+    }
+    staleCount += removed.size() - before;
+    if (staleCount > MIN_PURGE && staleCount > entryCount / 8)
+    {
+        purge();
+    }
+}
+
+// Entries of 'id' about to be added again are live as they stand: take
+// them off its stale list and out of 'grams'
+void TitleIndex::revive(int id, std::vector<uint32_t> &grams)
+{
+    std::unordered_map<int, std::vector<uint32_t> >::iterator found = stale.find(id);
+    if (found == stale.end())
+    {
+        return;
+    }
+    std::vector<uint32_t> &removed = found->second;
+    std::vector<uint32_t> stillStale, fresh;
+    std::set_difference(removed.begin(), removed.end(), grams.begin(), grams.end(), std::back_inserter(stillStale));
+    std::set_difference(grams.begin(), grams.end(), removed.begin(), removed.end(), std::back_inserter(fresh));
+    staleCount -= removed.size() - stillStale.size();
+    grams.swap(fresh);
+    if (stillStale.empty())
+    {
+        stale.erase(found);
+    }
+    else
+    {
+        removed.swap(stillStale);
+    }
+}
+
+// Drop the sorted IDs in 'ids' from a posting list in one pass
+void TitleIndex::eraseIds(std::vector<int> &list, const std::vector<int> &ids)
+{
+    std::vector<int>::iterator kept = list.begin();
+    size_t next = 0;
+    for (std::vector<int>::iterator it = list.begin(); it != list.end(); ++it)
+    {
+        while (next < ids.size() && ids[next] < *it)
+        {
+            next++;
+        }
+        if (next == ids.size() || ids[next] != *it)
+        {
+            *kept++ = *it;
+        }
+    }
+    list.erase(kept, list.end());
+}
+
+// Erase every stale entry, one pass per affected posting list
+void TitleIndex::purge()
+{
+    std::vector<std::pair<uint32_t, int> > keys;
+    keys.reserve(staleCount);
+    for (std::unordered_map<int, std::vector<uint32_t> >::const_iterator it = stale.begin(); it != stale.end(); ++it)
+    {
+        for (size_t i = 0; i < it->second.size(); i++)
+        {
+            keys.push_back(std::make_pair(it->second[i], it->first));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    stale.clear();
+    staleCount = 0;
+
+    std::vector<int> ids;
+    for (size_t k = 0; k < keys.size();)
+    {
+        uint32_t gram = keys[k].first;
+        ids.clear();
+        for (; k < keys.size() && keys[k].first == gram; k++)
+        {
+            ids.push_back(keys[k].second);
+        }
+        std::unordered_map<uint32_t, std::vector<int> >::iterator found = postings.find(gram);
+        if (found == postings.end())
+        {
+            continue;
+        }
+        size_t before = found->second.size();
+        eraseIds(found->second, ids);
+        entryCount -= before - found->second.size();
+        if (found->second.empty())
+        {
+            postings.erase(found);
+        }
+    }
+}
+
+// Turn (id, title) pairs into (trigram, id) keys
+void TitleIndex::collectKeys(const std::vector<std::pair<int, TextView> > &titles,
+                             std::vector<std::pair<uint32_t, int> > &keys)
+{
+    std::vector<uint32_t> grams;
+    keys.clear();
+    for (size_t i = 0; i < titles.size(); i++)
+    {
+        trigramsOf(titles[i].second, grams);
+        for (size_t g = 0; g < grams.size(); g++)
+        {
+            keys.push_back(std::make_pair(grams[g], titles[i].first));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+// Walk both key lists trigram by trigram; each affected list is filtered
+// and merged once
+void TitleIndex::update(const std::vector<std::pair<int, TextView> > &removals,
+                        const std::vector<std::pair<int, TextView> > &additions)
+{
+    std::vector<std::pair<uint32_t, int> > removeKeys, addKeys;
+    collectKeys(removals, removeKeys);
+    collectKeys(additions, addKeys);
+    if (!stale.empty())
+    {
+        // Stale entries being added again are live as they stand
+        std::vector<uint32_t> grams;
+        for (size_t i = 0; i < additions.size(); i++)
+        {
+            trigramsOf(additions[i].second, grams);
+            revive(additions[i].first, grams);
+        }
+    }
+
+    std::vector<int> removeIds, addIds, merged;
+    size_t r = 0, a = 0;
+    while (r < removeKeys.size() || a < addKeys.size())
+    {
+        uint32_t gram;
+        if (a == addKeys.size() || (r < removeKeys.size() && removeKeys[r].first < addKeys[a].first))
+        {
+            gram = removeKeys[r].first;
+        }
+        else
+        {
+            gram = addKeys[a].first;
+        }
+
+        removeIds.clear();
+        for (; r < removeKeys.size() && removeKeys[r].first == gram; r++)
+        {
+            removeIds.push_back(removeKeys[r].second);
+        }
+        addIds.clear();
+        for (; a < addKeys.size() && addKeys[a].first == gram; a++)
+        {
+            addIds.push_back(addKeys[a].second);
+        }
+
+        std::vector<int> &list = postings[gram];
+        size_t before = list.size();
+        if (!removeIds.empty())
+        {
+            // Removals are applied first, so an ID both removed and added stays
+            eraseIds(list, removeIds);
+        }
+        if (!addIds.empty())
+        {
+            if (list.empty() || list.back() < addIds.front())
+            {
+                list.insert(list.end(), addIds.begin(), addIds.end());
+            }
+            else
+            {
+                merged.clear();
+                std::set_union(list.begin(), list.end(), addIds.begin(), addIds.end(), std::back_inserter(merged));
+                list.swap(merged);
+            }
+        }
+        entryCount += list.size();
+        entryCount -= before;
+        if (list.empty())
+        {
+            postings.erase(gram);
+        }
+    }
+}
+
+void TitleIndex::clear()
+{
+    postings.clear();
+    stale.clear();
+    staleCount = 0;
+    entryCount = 0;
+}
+
+// Intersect the postings of every trigram in the query, smallest list first
+bool TitleIndex::findCandidates(const std::string &term, std::vector<int> &candidates) const
+{
+    candidates.clear();
+    if (term.size() < MIN_QUERY_LENGTH)
+    {
+        return false;
+    }
+
+    std::vector<uint32_t> grams;
+    trigramsOf(term, grams);
+
+    std::vector<const std::vector<int> *> lists;
+    for (size_t i = 0; i < grams.size(); i++)
+    {
+        std::unordered_map<uint32_t, std::vector<int> >::const_iterator found = postings.find(grams[i]);
+        if (found == postings.end())
+        {
+            return true; // A trigram nobody has: no matches at all
+        }
+        lists.push_back(&found->second);
+    }
+
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int> *a, const std::vector<int> *b) { return a->size() < b->size(); });
+
+    candidates = *lists[0];
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+    {
+        const std::vector<int> &list = *lists[i];
+        size_t kept = 0;
+        if (list.size() / 16 > candidates.size())
+        {
+            // Few candidates against a long list: binary search each one
+            for (size_t c = 0; c < candidates.size(); c++)
+            {
+                if (std::binary_search(list.begin(), list.end(), candidates[c]))
+                {
+                    candidates[kept++] = candidates[c];
+                }
+            }
+        }
+        else
+        {
+            // Similar sizes: a linear merge is cheaper
+            size_t l = 0;
+            for (size_t c = 0; c < candidates.size() && l < list.size(); c++)
+            {
+                while (l < list.size() && list[l] < candidates[c])
+                {
+                    l++;
+                }
+                if (l < list.size() && list[l] == candidates[c])
+                {
+                    candidates[kept++] = candidates[c];
+                }
+            }
+        }
+        candidates.resize(kept);
+    }
+
+    // Skip removed titles still waiting to be purged from these lists
+    if (!stale.empty())
+    {
+        size_t kept = 0;
+        for (size_t c = 0; c < candidates.size(); c++)
+        {
+            std::unordered_map<int, std::vector<uint32_t> >::const_iterator found = stale.find(candidates[c]);
+            if (found == stale.end() || !sharesAny(found->second, grams))
+            {
+                candidates[kept++] = candidates[c];
+            }
+        }
+        candidates.resize(kept);
+    }
+    return true;
+}
+
+// Size of the shortest posting list among the query's trigrams
+bool TitleIndex::estimateCandidates(const std::string &term, size_t &estimate) const
+{
+    if (term.size() < MIN_QUERY_LENGTH)
+    {
+        return false;
+    }
+
+    std::vector<uint32_t> grams;
+    trigramsOf(term, grams);
+
+    estimate = static_cast<size_t>(-1);
+    for (size_t i = 0; i < grams.size() && estimate > 0; i++)
+    {
+        std::unordered_map<uint32_t, std::vector<int> >::const_iterator found = postings.find(grams[i]);
+        size_t length = found == postings.end() ? 0 : found->second.size();
+        if (length < estimate)
+        {
+            estimate = length;
+        }
+    }
+    return true;
+}
+
+void TitleIndex::postingLengths(TextView term, std::vector<size_t> &lengths) const
+{
+    lengths.clear();
+    for (size_t i = 0; i + 2 < term.size(); i++)
+    {
+        std::unordered_map<uint32_t, std::vector<int> >::const_iterator found = postings.find(packTrigram(term, i));
+        lengths.push_back(found == postings.end() ? 0 : found->second.size());
+    }
+}
+
+// Pigeonhole filter: split the term into edits + 1 pieces and take every
+// title containing one of them. The split is chosen (by dynamic
+// programming over the cut points) to minimize the summed estimates, each
+// piece's estimate being its shortest posting list.
+bool TitleIndex::findApproximate(const std::string &term, int edits, std::vector<int> &candidates) const
+{
+    candidates.clear();
+    size_t pieces = static_cast<size_t>(edits < 0 ? 0 : edits) + 1;
+    size_t n = term.size();
+    if (n < pieces * MIN_QUERY_LENGTH)
+    {
+        return false;
+    }
+
+    std::vector<size_t> lengths;
+    postingLengths(term, lengths);
+
+    // best[j][p]: smallest estimate total for the first p bytes in j pieces
+    const size_t unreachable = static_cast<size_t>(-1);
+    std::vector<std::vector<size_t> > best(pieces + 1, std::vector<size_t>(n + 1, unreachable));
+    std::vector<std::vector<size_t> > cut(pieces + 1, std::vector<size_t>(n + 1, 0));
+    best[0][0] = 0;
+    for (size_t j = 1; j <= pieces; j++)
+    {
+        for (size_t p = j * MIN_QUERY_LENGTH; p + (pieces - j) * MIN_QUERY_LENGTH <= n; p++)
+        {
+            // Walk the piece's start back from p - 3, keeping its estimate
+            size_t estimate = unreachable;
+            for (size_t start = p - MIN_QUERY_LENGTH + 1; start-- > (j - 1) * MIN_QUERY_LENGTH;)
+            {
+                estimate = std::min(estimate, lengths[start]);
+                if (best[j - 1][start] == unreachable)
+                {
+                    continue;
+                }
+                if (best[j - 1][start] + estimate < best[j][p])
+                {
+                    best[j][p] = best[j - 1][start] + estimate;
+                    cut[j][p] = start;
+                }
+            }
+        }
+    }
+
+    // Union of the pieces' (sorted) candidates
+    std::vector<int> ids, merged;
+    for (size_t j = pieces, p = n; j > 0; j--)
+    {
+        size_t start = cut[j][p];
+        findCandidates(term.substr(start, p - start), ids);
+        merged.clear();
+        std::set_union(candidates.begin(), candidates.end(), ids.begin(), ids.end(), std::back_inserter(merged));
+        candidates.swap(merged);
+        p = start;
+    }
+    return true;
+}
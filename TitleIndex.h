@@ -0,0 +1,84 @@
+#ifndef TITLEINDEX_H
+#define TITLEINDEX_H
+
+#include "StringPool.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+
+// Inverted trigram index over movie titles. Every case-folded, three-byte
+// window of a title maps to a sorted posting list of movie IDs, so a
+// substring query only has to intersect the postings of its own trigrams
+// instead of looking at every title. The result is a candidate set: every
+// real match is in it, and the caller confirms each candidate against the
+// title itself.
+class TitleIndex
+{
+private:
+    std::unordered_map<uint32_t, std::vector<int> > postings; // Trigram -> sorted movie IDs
+    std::vector<uint32_t> scratch;                            // Reused by add/remove
+    std::unordered_map<int, std::vector<uint32_t> > stale;    // ID -> trigrams it was removed from, not yet erased
+    size_t staleCount;                                        // Entries listed in 'stale'
+    size_t entryCount;                                        // Entries in all posting lists, stale included
+
+    // Stale entries always tolerated before a purge
+    static const size_t MIN_PURGE = 4096;
+
+    // Take the entries of a title being added back off its stale list,
+    // leaving in 'grams' only the trigrams it still has to be added to
+    void revive(int id, std::vector<uint32_t> &grams);
+
+    // Erase every stale entry from the posting lists
+    void purge();
+
+    // Drop sorted IDs from one posting list
+    static void eraseIds(std::vector<int> &list, const std::vector<int> &ids);
+
+    // Distinct trigrams of a string, case-folded
+    static void trigramsOf(TextView text, std::vector<uint32_t> &out);
+
+    // Length of the posting list of each trigram position in a term
+    void postingLengths(TextView term, std::vector<size_t> &lengths) const;
+
+    // (trigram, id) pairs of many titles, sorted by trigram then ID
+    static void collectKeys(const std::vector<std::pair<int, TextView> > &titles,
+                            std::vector<std::pair<uint32_t, int> > &keys);
+
+public:
+    TitleIndex();
+
+    // Shortest query the index can answer; shorter ones need a scan
+    static const size_t MIN_QUERY_LENGTH = 3;
+
+    // Index / unindex one title
+    void add(int id, TextView name);
+    void remove(int id, TextView name);
+
+    // Unindex and index many titles at once: every posting list touched is
+    // rewritten in a single merge instead of one sorted insert/erase per title
+    void update(const std::vector<std::pair<int, TextView> > &removals,
+                const std::vector<std::pair<int, TextView> > &additions);
+
+    // Drop everything
+    void clear();
+
+    // Candidate IDs (ascending) for a substring query. Returns false when
+    // the query is too short to use the index.
+    bool findCandidates(const std::string &term, std::vector<int> &candidates) const;
+
+    // Cheap upper bound on the candidate count: the shortest posting list
+    // of the query's trigrams. Returns false like findCandidates.
+    bool estimateCandidates(const std::string &term, size_t &estimate) const;
+
+    // Candidate IDs (ascending) for titles that may contain the term with
+    // at most 'edits' edits. The term is split into edits + 1 pieces of a
+    // trigram or longer; every such title contains one piece unchanged, so
+    // no match is left out. Returns false when the term is too short to
+    // split that way: it then has no more trigrams than the edits can
+    // destroy, and only a scan finds every match.
+    bool findApproximate(const std::string &term, int edits, std::vector<int> &candidates) const;
+};
+
+#endif // TITLEINDEX_H
@@ -24,6 +24,30 @@ if %ERRORLEVEL% NEQ 0 (
     exit /b 1
 )
 
+echo Compiling StringPool.cpp...
+g++ -std=c++11 -c StringPool.cpp -o StringPool.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile StringPool.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling MovieRenderer.cpp...
+g++ -std=c++11 -c MovieRenderer.cpp -o MovieRenderer.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile MovieRenderer.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling MovieExporter.cpp...
+g++ -std=c++11 -c MovieExporter.cpp -o MovieExporter.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile MovieExporter.cpp
+    pause
+    exit /b 1
+)
+
 echo Compiling MovieDatabase.cpp...
 g++ -std=c++11 -c MovieDatabase.cpp -o MovieDatabase.o
 if %ERRORLEVEL% NEQ 0 (
@@ -32,6 +56,134 @@ if %ERRORLEVEL% NEQ 0 (
     exit /b 1
 )
 
+echo Compiling ConcurrentMovieDatabase.cpp...
+g++ -std=c++11 -c ConcurrentMovieDatabase.cpp -o ConcurrentMovieDatabase.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile ConcurrentMovieDatabase.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling MovieFile.cpp...
+g++ -std=c++11 -c MovieFile.cpp -o MovieFile.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile MovieFile.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling MovieJournal.cpp...
+g++ -std=c++11 -c MovieJournal.cpp -o MovieJournal.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile MovieJournal.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling MovieImporter.cpp...
+g++ -std=c++11 -c MovieImporter.cpp -o MovieImporter.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile MovieImporter.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling TitleIndex.cpp...
+g++ -std=c++11 -c TitleIndex.cpp -o TitleIndex.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile TitleIndex.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling FuzzyMatcher.cpp...
+g++ -std=c++11 -c FuzzyMatcher.cpp -o FuzzyMatcher.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile FuzzyMatcher.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling OrderIndex.cpp...
+g++ -std=c++11 -c OrderIndex.cpp -o OrderIndex.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile OrderIndex.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling CatalogStats.cpp...
+g++ -std=c++11 -c CatalogStats.cpp -o CatalogStats.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile CatalogStats.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling MovieQuery.cpp...
+g++ -std=c++11 -c MovieQuery.cpp -o MovieQuery.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile MovieQuery.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling QueryCache.cpp...
+g++ -std=c++11 -c QueryCache.cpp -o QueryCache.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile QueryCache.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling MovieCursor.cpp...
+g++ -std=c++11 -c MovieCursor.cpp -o MovieCursor.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile MovieCursor.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling MovieBatch.cpp...
+g++ -std=c++11 -c MovieBatch.cpp -o MovieBatch.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile MovieBatch.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling LanguageDictionary.cpp...
+g++ -std=c++11 -c LanguageDictionary.cpp -o LanguageDictionary.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile LanguageDictionary.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling MovieColumns.cpp...
+g++ -std=c++11 -c MovieColumns.cpp -o MovieColumns.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile MovieColumns.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling ScanKernels.cpp...
+g++ -std=c++11 -c ScanKernels.cpp -o ScanKernels.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile ScanKernels.cpp
+    pause
+    exit /b 1
+)
+
+echo Compiling ScanExecutor.cpp...
+g++ -std=c++11 -c ScanExecutor.cpp -o ScanExecutor.o
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile ScanExecutor.cpp
+    pause
+    exit /b 1
+)
+
 echo Compiling main.cpp...
 g++ -std=c++11 -c main.cpp -o main.o
 if %ERRORLEVEL% NEQ 0 (
@@ -41,7 +193,7 @@ if %ERRORLEVEL% NEQ 0 (
 )
 
 echo Linking object files...
-g++ -std=c++11 Movie.o MovieDatabase.o main.o -o MovieDatabase.exe
+g++ -std=c++11 -pthread Movie.o StringPool.o MovieRenderer.o MovieExporter.o MovieDatabase.o ConcurrentMovieDatabase.o MovieFile.o MovieJournal.o MovieImporter.o TitleIndex.o FuzzyMatcher.o OrderIndex.o CatalogStats.o MovieQuery.o QueryCache.o MovieCursor.o MovieBatch.o LanguageDictionary.o MovieColumns.o ScanKernels.o ScanExecutor.o main.o -o MovieDatabase.exe
 if %ERRORLEVEL% NEQ 0 (
     echo ERROR: Failed to link
     pause
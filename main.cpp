@@ -1,7 +1,14 @@
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <sstream>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include <utility>
 #include "MovieDatabase.h"
+#include "MovieRenderer.h"
+#include "MovieBatch.h"
 
 using namespace std;
 
@@ -26,9 +33,10 @@ void displayMenu() {
     cout << "  8.  Update Movie Information" << endl;
     cout << "  9.  View Database Statistics" << endl;
     cout << "  10. Change Display Style" << endl;
+    cout << "  11. Advanced Search (combine filters)" << endl;
     cout << "  0.  Exit Program" << endl;
     cout << string(100, '=') << endl;
-    cout << "Enter your choice (0-10): ";
+    cout << "Enter your choice (0-11): ";
 }
 
 // Function to change rating display style
@@ -72,11 +80,6 @@ void addNewMovie(MovieDatabase& database) {
     cout << "                              ADD NEW MOVIE" << endl;
     cout << string(100, '=') << endl;
     
-    if (database.isFull()) {
-        cout << "\nError: Database is full! Cannot add more movies." << endl;
-        return;
-    }
-    
     string name, language;
     int year;
     double rating;
@@ -100,7 +103,7 @@ void addNewMovie(MovieDatabase& database) {
     
     Movie newMovie(name, id, year, language, rating);
     
-    if (database.addMovie(newMovie)) {
+    if (database.addMovie(std::move(newMovie))) {
         cout << "\n" << string(60, '=') << endl;
         cout << "  SUCCESS! Movie added to database" << endl;
         cout << string(60, '=') << endl;
@@ -125,8 +128,8 @@ void addNewMovie(MovieDatabase& database) {
         cout << endl;
         cout << string(60, '=') << endl;
         
-        // Save changes to file
-        if (database.saveToFile("movies.dat")) {
+        // Append the change to the journal (no full rewrite of movies.dat)
+        if (database.persistChanges()) {
             cout << "\n? Changes saved successfully!" << endl;
         } else {
             cout << "\n? Warning: Could not save changes to file!" << endl;
@@ -152,8 +155,8 @@ void removeMovie(MovieDatabase& database) {
         cout << "  Movie ID: " << id << endl;
         cout << string(60, '=') << endl;
         
-        // Save changes to file
-        if (database.saveToFile("movies.dat")) {
+        // Append the change to the journal (no full rewrite of movies.dat)
+        if (database.persistChanges()) {
             cout << "\n? Changes saved successfully!" << endl;
         } else {
             cout << "\n? Warning: Could not save changes to file!" << endl;
@@ -173,7 +176,7 @@ void updateMovie(MovieDatabase& database) {
     cout << "\nEnter the ID of the movie to update: ";
     cin >> id;
     
-    Movie* movie = database.findMovieById(id);
+    const Movie* movie = database.findMovieById(id);
     if (movie == nullptr) {
         cout << "\n? Movie not found with ID: " << id << endl;
         return;
@@ -220,8 +223,8 @@ void updateMovie(MovieDatabase& database) {
         cout << "  SUCCESS! Movie updated" << endl;
         cout << string(60, '=') << endl;
         
-        // Save changes to file
-        if (database.saveToFile("movies.dat")) {
+        // Append the change to the journal (no full rewrite of movies.dat)
+        if (database.persistChanges()) {
             cout << "\n? Changes saved successfully!" << endl;
         } else {
             cout << "\n? Warning: Could not save changes to file!" << endl;
@@ -231,6 +234,55 @@ void updateMovie(MovieDatabase& database) {
     }
 }
 
+// Rows shown per page when browsing results
+const size_t PAGE_SIZE = 20;
+
+// Closest titles offered when a search finds nothing
+const size_t SUGGESTION_COUNT = 10;
+
+// Show a query's results a page at a time; returns how many were shown.
+// Only the rows on the pages the user actually views are read and formatted.
+size_t browseResults(MovieDatabase& database, const MovieQuery& query, const string& title) {
+    MovieCursor cursor = database.openCursor(query);
+    vector<const Movie*> page;
+    
+    MovieRenderer renderer;
+    renderer.addTitle(title);
+    while (database.nextPage(cursor, PAGE_SIZE, page)) {
+        for (size_t i = 0; i < page.size(); i++) {
+            renderer.addRow(*page[i]);
+        }
+        renderer.flush();
+        if (!cursor.hasMore()) {
+            break;
+        }
+        
+        cout << "-- Showing " << cursor.getReturnedCount() - page.size() + 1 << "-" << cursor.getReturnedCount()
+             << ". Press Enter for more, or q to stop: ";
+        string answer;
+        getline(cin, answer);
+        if (!cin || answer == "q" || answer == "Q") {
+            break;
+        }
+    }
+    renderer.flush();
+    return cursor.getReturnedCount();
+}
+
+// Function to browse every movie page by page
+void browseAllMovies(MovieDatabase& database) {
+    if (database.getMovieCount() == 0) {
+        cout << "\nThe database is empty!" << endl;
+        return;
+    }
+    clearInput();
+    
+    size_t shown = browseResults(database, MovieQuery(), "COMPLETE MOVIE DATABASE");
+    cout << string(100, '-') << endl;
+    cout << "Movies shown: " << shown << " of " << database.getMovieCount() << endl;
+    cout << string(100, '=') << endl;
+}
+
 // Function to search movies by name
 void searchMovies(MovieDatabase& database) {
     cout << "\n" << string(100, '=') << endl;
@@ -249,7 +301,35 @@ void searchMovies(MovieDatabase& database) {
         return;
     }
     
-    database.searchMovieByName(searchTerm);
+    size_t shown = browseResults(database, MovieQuery().nameContains(searchTerm),
+                                 "SEARCH RESULTS FOR: \"" + searchTerm + "\"");
+    if (shown == 0) {
+        // No exact match: offer the closest titles instead (typo-tolerant)
+        vector<TitleMatch> similar;
+        database.findSimilarNames(searchTerm, SUGGESTION_COUNT, similar);
+        if (!similar.empty()) {
+            MovieRenderer renderer;
+            renderer.addTitle("NO EXACT MATCH FOR \"" + searchTerm + "\" - DID YOU MEAN");
+            for (size_t i = 0; i < similar.size(); i++) {
+                renderer.addRow(*similar[i].movie);
+            }
+            renderer.flush();
+            cout << string(100, '-') << endl;
+            cout << "Closest matches shown: " << similar.size() << " (" << similar[0].distance
+                 << " edit(s) away at best)" << endl;
+            cout << string(100, '=') << endl;
+            return;
+        }
+        cout << "No movies found matching \"" << searchTerm << "\"" << endl;
+        cout << "\nSearch Tips:" << endl;
+        cout << "  � Search is case-insensitive ('inception', 'INCEPTION', 'Inception' all work)" << endl;
+        cout << "  � Partial names work (search 'lord' finds 'Lord of the Rings')" << endl;
+        cout << "  � Try different keywords or spellings" << endl;
+        cout << "\nExamples: 'godfather', 'dark knight', 'spirited', 'parasite'" << endl;
+    }
+    cout << string(100, '-') << endl;
+    cout << "Matches shown: " << shown << endl;
+    cout << string(100, '=') << endl;
 }
 
 // Function to view movies by language
@@ -273,7 +353,71 @@ void viewByLanguage(MovieDatabase& database) {
         return;
     }
     
-    database.displayMoviesByLanguage(language);
+    size_t shown = browseResults(database, MovieQuery().language(language), "MOVIES IN " + language);
+    if (shown == 0) {
+        cout << "No movies found in " << language << endl;
+        cout << "\nTip: Language names are case-insensitive (e.g., 'english', 'ENGLISH', 'English' all work)" << endl;
+        database.displayAvailableLanguages();
+    }
+    cout << string(100, '-') << endl;
+    cout << "Movies shown: " << shown << " of " << database.getLanguageCount(language)
+         << " in " << language << endl;
+    cout << string(100, '=') << endl;
+}
+
+// Ask for an optional value; returns false when the user leaves it blank
+bool promptOptional(const string& prompt, string& value) {
+    cout << prompt;
+    getline(cin, value);
+    return !value.empty();
+}
+
+// Function to build and run a combined query
+void advancedSearch(MovieDatabase& database) {
+    cout << "\n" << string(100, '=') << endl;
+    cout << "                              ADVANCED SEARCH" << endl;
+    cout << string(100, '=') << endl;
+    cout << "\nLeave any filter blank to skip it." << endl;
+    
+    MovieQuery query;
+    string input;
+    clearInput();
+    
+    if (promptOptional("Name contains......: ", input)) {
+        query.nameContains(input);
+    }
+    if (promptOptional("Language...........: ", input)) {
+        query.language(input);
+    }
+    if (promptOptional("Years (from to)....: ", input)) {
+        istringstream range(input);
+        int from, to;
+        if (range >> from >> to) {
+            query.years(from, to);
+        } else {
+            cout << "? Ignoring invalid year range" << endl;
+        }
+    }
+    if (promptOptional("Ratings (min max)..: ", input)) {
+        istringstream range(input);
+        double low, high;
+        if (range >> low >> high) {
+            query.ratings(low, high);
+        } else {
+            cout << "? Ignoring invalid rating range" << endl;
+        }
+    }
+    if (promptOptional("Sort (1=rating 2=year 3=name 4=ID, blank=database order): ", input)) {
+        int order = atoi(input.c_str());
+        if (order >= MovieQuery::ORDER_RATING && order <= MovieQuery::ORDER_ID) {
+            query.orderBy(static_cast<MovieQuery::Order>(order));
+        }
+    }
+    if (promptOptional("Maximum results....: ", input)) {
+        query.limit(atoi(input.c_str()));
+    }
+    
+    database.displayQuery(query, "ADVANCED SEARCH RESULTS");
 }
 
 // Function to display database statistics
@@ -283,37 +427,177 @@ void displayStatistics(MovieDatabase& database) {
     cout << string(100, '=') << endl;
     
     int total = database.getMovieCount();
-    int capacity = database.getMaxCapacity(); // Get actual capacity (100,000)
+    int capacity = database.getCapacity(); // Reserved slots; storage grows on demand
     int available = capacity - total;
-    float percentFull = (total * 100.0) / capacity;
+    float percentFull = capacity > 0 ? (total * 100.0) / capacity : 0.0f;
     
     cout << "\n  Total Movies........: " << total << endl;
-    cout << "  Database Capacity...: " << capacity << " movies" << endl;
-    cout << "  Available Slots.....: " << available << " movies" << endl;
+    cout << "  Reserved Storage....: " << capacity << " movies" << endl;
+    cout << "  Free Reserved Slots.: " << available << " movies" << endl;
     cout << "  Usage Percentage....: " << fixed << setprecision(2) << percentFull << "%" << endl;
-    cout << "  Database Status.....: " << (database.isFull() ? "FULL" : "Available") << endl;
+    cout << "  Database Status.....: Available (grows automatically)" << endl;
     
     // Draw progress bar
-    cout << "\n  Capacity Usage: [";
+    cout << "\n  Reserved Storage Usage: [";
     int bars = (int)(percentFull / 5);
     for (int i = 0; i < bars; i++) cout << "#";
     for (int i = bars; i < 20; i++) cout << "-";
     cout << "] " << fixed << setprecision(2) << percentFull << "%" << endl;
     
+    // Catalog aggregates (kept up to date by the database, no scan needed)
+    if (total > 0) {
+        const CatalogStats& stats = database.getCatalogStats();
+        cout << "\n  Average Rating......: " << fixed << setprecision(2) << stats.getMeanRating() << "/10" << endl;
+        cout << "  Rating Range........: " << setprecision(1) << stats.getMinRating() << " - " << stats.getMaxRating() << endl;
+        cout << "  Release Years.......: " << stats.getMinYear() << " - " << stats.getMaxYear() << endl;
+        
+        // Histogram bins are tenths from 1.0; group them by whole star
+        cout << "  Movies by Star......:";
+        for (int bin = 0, star = 1; star <= 10; star++) {
+            int count = 0;
+            for (; bin < CatalogStats::RATING_BINS && 1 + bin / 10 == star; bin++) count += stats.getRatingBin(bin);
+            cout << " " << star << ":" << count;
+        }
+        cout << endl;
+    }
+    
+    // Repeated searches are answered from the result cache until the next edit
+    QueryCache::Stats cache = database.getQueryCacheStats();
+    cout << "\n  Query Cache.........: " << cache.hits << " hits, " << cache.misses << " misses ("
+         << cache.entries << " results cached)" << endl;
+    
     cout << "\n" << string(100, '=') << endl;
 }
 
+// True when a file is there to open, so a load that failed on a damaged
+// file can be told apart from a data file that doesn't exist yet
+bool fileExists(const string& path) {
+    ifstream file(path.c_str(), ios::binary);
+    return file.is_open();
+}
+
+// Function to print command-line usage
+void printUsage(const char* program) {
+    cerr << "Usage: " << program << "                                     interactive menu" << endl;
+    cerr << "       " << program << " --batch [script] [options]          apply a script (stdin if omitted or -)" << endl;
+    cerr << "       " << program << " --export csv|jsonl [file] [options] write every movie (stdout if no file)" << endl;
+    cerr << "Options: --data FILE   data file (default movies.dat)" << endl;
+    cerr << "         --dry-run     run the batch but do not save it" << endl;
+}
+
+// Apply a batch script as one transaction: everything is saved with a
+// single rewrite of the data file, or nothing is if any command fails.
+// Results go to stdout as JSON lines, ending with a status line.
+int runBatch(const string& scriptPath, const string& dataFile, bool dryRun) {
+    ifstream scriptFile;
+    if (scriptPath != "-") {
+        scriptFile.open(scriptPath.c_str());
+        if (!scriptFile.is_open()) {
+            cerr << "Error: Could not open script: " << scriptPath << endl;
+            return 1;
+        }
+    }
+    istream& script = scriptPath == "-" ? cin : scriptFile;
+    
+    // Load (replaying any journal) without logging the batch edits. A
+    // missing file starts empty; one that won't load is never saved over.
+    MovieDatabase database;
+    database.setStorageMode(MovieDatabase::STORAGE_POOLED);
+    if (!database.loadFromFile(dataFile) && fileExists(dataFile)) {
+        cerr << "Error: Could not load " << dataFile << "; nothing was changed" << endl;
+        cout << "{\"status\":\"load_failed\"}" << endl;
+        return 1;
+    }
+    
+    MovieBatch batch(database, cout);
+    bool ok = batch.run(script);
+    
+    // One checkpoint writes the data file once and empties the journal
+    bool saved = ok && !dryRun && database.openJournal(dataFile) && database.checkpoint();
+    
+    const char* status = !ok ? "rolled_back" : dryRun ? "dry_run" : saved ? "committed" : "save_failed";
+    cout << "{\"status\":\"" << status << "\""
+         << ",\"added\":" << batch.getAdded()
+         << ",\"updated\":" << batch.getUpdated()
+         << ",\"removed\":" << batch.getRemoved()
+         << ",\"queries\":" << batch.getQueries();
+    if (ok) {
+        cout << ",\"movies\":" << database.getMovieCount();
+    } else {
+        cout << ",\"failed_line\":" << batch.getFailedLine();
+    }
+    cout << "}" << endl;
+    return (ok && (saved || dryRun)) ? 0 : 1;
+}
+
+// Export the data file as CSV or JSON Lines (stdout if no file given)
+int runExport(const string& formatName, const string& outputPath, const string& dataFile) {
+    MovieExporter::Format format;
+    if (!MovieExporter::parseFormat(formatName, format)) {
+        cerr << "Error: Unknown export format: " << formatName << " (use csv or jsonl)" << endl;
+        return 2;
+    }
+    MovieDatabase database;
+    database.setStorageMode(MovieDatabase::STORAGE_POOLED);
+    if (!database.loadFromFile(dataFile) && fileExists(dataFile)) {
+        cerr << "Error: Could not load " << dataFile << endl;
+        return 1;
+    }
+    bool ok = outputPath.empty() ? database.exportMovies(cout, format)
+                                 : database.exportToFile(outputPath, format);
+    return ok ? 0 : 1;
+}
+
 // Main program entry point
-int main() {
-    // Create a database to store movies
+int main(int argc, char* argv[]) {
+    // Command-line modes for scripts and other programs
+    if (argc > 1) {
+        string mode = argv[1];
+        string dataFile = "movies.dat";
+        bool dryRun = false;
+        vector<string> arguments;
+        for (int i = 2; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--data" && i + 1 < argc) {
+                dataFile = argv[++i];
+            } else if (arg == "--dry-run") {
+                dryRun = true;
+            } else {
+                arguments.push_back(arg);
+            }
+        }
+        if (mode == "--batch" && arguments.size() <= 1) {
+            return runBatch(arguments.empty() ? "-" : arguments[0], dataFile, dryRun);
+        }
+        if (mode == "--export" && (arguments.size() == 1 || arguments.size() == 2)) {
+            return runExport(arguments[0], arguments.size() == 2 ? arguments[1] : "", dataFile);
+        }
+        printUsage(argv[0]);
+        return 2;
+    }
+    
+    // Create a database to store movies (names packed into shared blocks)
     MovieDatabase database;
+    database.setStorageMode(MovieDatabase::STORAGE_POOLED);
+    
+    // Try to load existing data from file (replays movies.dat.wal too)
+    bool loaded = database.loadFromFile("movies.dat");
+    if (!loaded && fileExists("movies.dat")) {
+        // Never write over a file that is there but won't load: it and its
+        // journal may be the only copy of the user's movies
+        cerr << "Error: movies.dat could not be loaded and has been left untouched." << endl;
+        cerr << "Move movies.dat and movies.dat.wal aside to start over with the sample movies." << endl;
+        return 1;
+    }
+    
+    // From now on edits are journaled instead of rewriting movies.dat
+    database.openJournal("movies.dat");
     
-    // Try to load existing data from file
-    if (!database.loadFromFile("movies.dat")) {
+    if (!loaded) {
         // If file doesn't exist, load the 50 sample movies
         database.initializeSampleData();
-        // Save initial data
-        database.saveToFile("movies.dat");
+        // Save initial data (this also discards any stale journal)
+        database.checkpoint();
         std::cout << "\nInitialized database with 50 sample movies." << std::endl;
     } else {
         std::cout << "\nLoaded existing database from file." << std::endl;
@@ -329,7 +613,7 @@ int main() {
     cout << string(100, '=') << endl;
     
     cout << "\nWelcome! The database has been initialized with " << database.getMovieCount() << " movies." << endl;
-    cout << "Database Capacity: " << database.getMaxCapacity() << " movies (Plenty of room to grow!)" << endl;
+    cout << "Database Capacity: unlimited (storage grows as you add movies)" << endl;
     cout << "Tip: Try option 10 to change the rating display style!" << endl;
     
     // Main program loop
@@ -342,14 +626,14 @@ int main() {
         
         // Check for input errors
         if (cin.fail()) {
-            cout << "\n? Invalid input! Please enter a number between 0 and 10." << endl;
+            cout << "\n? Invalid input! Please enter a number between 0 and 11." << endl;
             clearInput();
             continue;
         }
         
         switch (choice) {
             case 1:
-                database.displayAllMovies();
+                browseAllMovies(database);
                 break;
                 
             case 2:
@@ -388,7 +672,14 @@ int main() {
                 changeDisplayStyle();
                 break;
                 
+            case 11:
+                advancedSearch(database);
+                break;
+                
             case 0:
+                // Fold the journal into movies.dat before leaving
+                database.closeJournal();
+                
                 cout << "\n" << string(100, '=') << endl;
                 cout << "                      THANK YOU FOR USING THE SYSTEM!" << endl;
                 cout << string(100, '=') << endl;
@@ -405,7 +696,7 @@ int main() {
                 break;
                 
             default:
-                cout << "\n? Invalid choice! Please enter a number between 0 and 10." << endl;
+                cout << "\n? Invalid choice! Please enter a number between 0 and 11." << endl;
                 break;
         }
         